@@ -1165,6 +1165,13 @@ enum CXTranslationUnit_Flags {
    * preamble or the files in it have not changed, \c
    * clang_reparseTranslationUnit() will re-use the implicit
    * precompiled header to improve parsing performance.
+   *
+   * Translation units in the same process that have the same preamble
+   * share its precompiled header. When the environment variable
+   * \c LIBCLANG_PREAMBLE_CACHE_PATH names a directory, precompiled
+   * preambles that produced no diagnostics and only depend on files on
+   * disk are also stored there, for other processes to re-use. Preambles
+   * that have not been used for a month are removed from that directory.
    */
   CXTranslationUnit_PrecompiledPreamble = 0x04,
   
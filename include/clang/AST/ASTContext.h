@@ -82,6 +82,7 @@ class ASTRecordLayout;
 class AtomicExpr;
 class BlockExpr;
 class CharUnits;
+class ConstexprBytecodeCache;
 class CXXABI;
 class DiagnosticsEngine;
 class Expr;
@@ -121,6 +122,17 @@ struct TypeInfo {
       : Width(Width), Align(Align), AlignIsRequired(AlignIsRequired) {}
 };
 
+/// \brief Holds the statements of a function body that may be released once
+/// code has been generated for the function (-ffree-function-bodies).
+struct FunctionBodyArena {
+  llvm::BumpPtrAllocator Allocator;
+
+  /// \brief Whether something outside of the function body may refer to the
+  /// statements in this arena, so that they must live as long as the
+  /// ASTContext.
+  bool Retained = false;
+};
+
 /// \brief Holds long-lived AST nodes (such as types and decls) that can be
 /// referred to throughout the semantic analysis of a file.
 class ASTContext : public RefCountedBase<ASTContext> {
@@ -478,6 +490,22 @@ private:
   /// AST objects will be released when the ASTContext itself is destroyed.
   mutable llvm::BumpPtrAllocator BumpAlloc;
 
+  /// \brief The arenas of the function bodies that may still be released,
+  /// keyed by function definition.
+  llvm::DenseMap<const FunctionDecl *, std::unique_ptr<FunctionBodyArena>>
+      FunctionBodyArenas;
+
+  /// \brief Arenas of function bodies that can no longer be released, because
+  /// the function was redefined.
+  std::vector<std::unique_ptr<FunctionBodyArena>> RetainedBodyArenas;
+
+  /// \brief The arena that new statements are allocated in, or null if they
+  /// are allocated along with the rest of the AST.
+  FunctionBodyArena *ActiveBodyArena = nullptr;
+
+  unsigned NumReleasedFunctionBodies = 0;
+  size_t ReleasedFunctionBodyMemory = 0;
+
   /// \brief Allocator for partial diagnostics.
   PartialDiagnostic::StorageAllocator DiagAllocator;
 
@@ -485,6 +513,9 @@ private:
   std::unique_ptr<CXXABI> ABI;
   CXXABI *createCXXABI(const TargetInfo &T);
 
+  /// \brief The bytecode of constexpr functions, created on first use.
+  mutable std::unique_ptr<ConstexprBytecodeCache> ConstexprBytecode;
+
   /// \brief The logical -> physical address space map.
   const LangAS::Map *AddrSpaceMap;
 
@@ -619,14 +650,47 @@ public:
     return static_cast<T *>(Allocate(Num * sizeof(T), alignof(T)));
   }
   void Deallocate(void *Ptr) const { }
-  
+
+  /// \brief Allocate memory for a statement or expression, in the arena of
+  /// the function body that is being built if there is one.
+  void *AllocateStmt(size_t Size, unsigned Align = 8) const {
+    if (ActiveBodyArena)
+      return ActiveBodyArena->Allocator.Allocate(Size, Align);
+    return BumpAlloc.Allocate(Size, Align);
+  }
+
+  /// \brief Create the arena that the statements of the body of \p FD will be
+  /// allocated in. The arena has to be made active by the caller.
+  FunctionBodyArena *createFunctionBodyArena(const FunctionDecl *FD);
+
+  /// \brief Retrieve the arena that new statements are allocated in, if any.
+  FunctionBodyArena *getActiveBodyArena() const { return ActiveBodyArena; }
+
+  /// \brief Set the arena that new statements are allocated in; null to
+  /// allocate them along with the rest of the AST.
+  void setActiveBodyArena(FunctionBodyArena *Arena) {
+    ActiveBodyArena = Arena;
+  }
+
+  /// \brief Release the memory of the statements in the body of \p FD, which
+  /// must no longer be referred to by anything.
+  ///
+  /// The body is replaced by an empty compound statement, so that the function
+  /// is still a definition.
+  ///
+  /// \returns true if the body was released, false if it was not allocated in
+  /// an arena of its own or has been retained.
+  bool releaseFunctionBody(const FunctionDecl *FD);
+
   /// Return the total amount of physical memory allocated for representing
   /// AST nodes and type information.
-  size_t getASTAllocatedMemory() const {
-    return BumpAlloc.getTotalMemory();
-  }
+  size_t getASTAllocatedMemory() const;
   /// Return the total memory used for various side tables.
   size_t getSideTableAllocatedMemory() const;
+
+  /// \brief Retrieve all of the types that have been created, in the order
+  /// they were created in.
+  ArrayRef<Type *> getTypes() const { return Types; }
   
   PartialDiagnostic::StorageAllocator &getDiagAllocator() {
     return DiagAllocator;
@@ -816,6 +880,11 @@ public:
     return CommentCommandTraits;
   }
 
+  /// \brief Retrieve the cache of constexpr functions compiled to bytecode,
+  /// used by the constant evaluator when
+  /// -fexperimental-constexpr-bytecode is enabled.
+  ConstexprBytecodeCache &getConstexprBytecodeCache() const;
+
   /// \brief Retrieve the attributes for the given declaration.
   AttrVec& getDeclAttrs(const Decl *D);
 
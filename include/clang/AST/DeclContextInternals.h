@@ -18,6 +18,7 @@
 #include "clang/AST/DeclCXX.h"
 #include "clang/AST/DeclarationName.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/PointerIntPair.h"
 #include "llvm/ADT/PointerUnion.h"
 #include "llvm/ADT/SmallVector.h"
@@ -242,10 +243,40 @@ class StoredDeclsMap
 public:
   static void DestroyAll(StoredDeclsMap *Map, bool Dependent);
 
+  /// \brief Print statistics about the maps in the chain starting at \p Map.
+  static void PrintStats(const StoredDeclsMap *Map);
+
+  /// \brief Determine whether the external source may have declarations of
+  /// the name of \p Entry that have not been loaded into its list yet.
+  bool mayHaveExternalDecls(const value_type &Entry) const {
+    return Entry.second.hasExternalDecls() ||
+           (HasPendingExternalDecls && !UpToDateNames.count(Entry.first));
+  }
+
+  /// \brief Record that the external declarations of \p Name have been
+  /// loaded into its list.
+  void setUpToDate(DeclarationName Name) {
+    if (HasPendingExternalDecls)
+      UpToDateNames.insert(Name);
+  }
+
 private:
   friend class ASTContext; // walks the chain deleting these
   friend class DeclContext;
   llvm::PointerIntPair<StoredDeclsMap*, 1> Previous;
+
+  /// \brief Whether the context gained external visible storage after this
+  /// map was built. If so, any name that is not in \c UpToDateNames may have
+  /// external declarations that have not been loaded.
+  ///
+  /// This allows new external storage to be reconciled with the map without
+  /// visiting every name in it, which is what makes extending a namespace
+  /// with many members from a series of modules affordable.
+  bool HasPendingExternalDecls = false;
+
+  /// \brief The names whose external declarations have been loaded since the
+  /// context last gained external visible storage.
+  llvm::DenseSet<DeclarationName> UpToDateNames;
 };
 
 class DependentStoredDeclsMap : public StoredDeclsMap {
@@ -74,6 +74,7 @@ namespace llvm {
 
 namespace clang {
   class ASTContext;
+  template <typename T> struct CachedProfileHashFoldingSetTrait;
   class TypedefNameDecl;
   class TemplateDecl;
   class TemplateTypeParmDecl;
@@ -3224,6 +3225,10 @@ private:
   /// Whether this function has a trailing return type.
   unsigned HasTrailingReturn : 1;
 
+  /// \brief The hash of this type's profile, or zero if it has not been
+  /// computed yet. Used by CachedProfileHashFoldingSetTrait.
+  unsigned ProfileHash;
+
   // ParamInfo - There is an variable size array after the class in memory that
   // holds the parameter types.
 
@@ -3244,6 +3249,7 @@ private:
   // is true.
 
   friend class ASTContext;  // ASTContext creates these.
+  template <typename T> friend struct CachedProfileHashFoldingSetTrait;
 
   const ExtParameterInfo *getExtParameterInfosBuffer() const {
     assert(hasExtParameterInfos());
@@ -4188,12 +4194,17 @@ class LLVM_ALIGNAS(/*alignof(uint64_t)*/ 8) TemplateSpecializationType
   /// Whether this template specialization type is a substituted type alias.
   unsigned TypeAlias : 1;
 
+  /// \brief The hash of this type's profile, or zero if it has not been
+  /// computed yet. Used by CachedProfileHashFoldingSetTrait.
+  unsigned ProfileHash;
+
   TemplateSpecializationType(TemplateName T,
                              ArrayRef<TemplateArgument> Args,
                              QualType Canon,
                              QualType Aliased);
 
   friend class ASTContext;  // ASTContext creates these
+  template <typename T> friend struct CachedProfileHashFoldingSetTrait;
 
 public:
   /// Determine whether any of the given template arguments are dependent.
@@ -4578,6 +4589,10 @@ class LLVM_ALIGNAS(/*alignof(uint64_t)*/ 8) DependentTemplateSpecializationType
   /// specialization.
   unsigned NumArgs;
 
+  /// \brief The hash of this type's profile, or zero if it has not been
+  /// computed yet. Used by CachedProfileHashFoldingSetTrait.
+  unsigned ProfileHash;
+
   const TemplateArgument *getArgBuffer() const {
     return reinterpret_cast<const TemplateArgument*>(this+1);
   }
@@ -4592,6 +4607,7 @@ class LLVM_ALIGNAS(/*alignof(uint64_t)*/ 8) DependentTemplateSpecializationType
                                       QualType Canon);
 
   friend class ASTContext;  // ASTContext creates these
+  template <typename T> friend struct CachedProfileHashFoldingSetTrait;
 
 public:
   NestedNameSpecifier *getQualifier() const { return NNS; }
@@ -5977,7 +5993,54 @@ QualType DecayedType::getPointeeType() const {
   return cast<PointerType>(Decayed)->getPointeeType();
 }
 
+/// \brief A trait for the ASTContext uniquing tables of types whose profile
+/// is expensive to compute, such as function types and template
+/// specializations, whose profiles cover all of their parameters or
+/// arguments.
+///
+/// The hash of each type's profile is computed once and kept in the type, so
+/// that looking up a type only profiles the nodes in its bucket whose hash
+/// matches, and growing the table does not profile anything.
+template <typename T> struct CachedProfileHashFoldingSetTrait {
+  static void Profile(T &X, llvm::FoldingSetNodeID &ID, ASTContext &Context) {
+    X.Profile(ID, Context);
+  }
+
+  static bool Equals(T &X, const llvm::FoldingSetNodeID &ID, unsigned IDHash,
+                     llvm::FoldingSetNodeID &TempID, ASTContext &Context) {
+    if (X.ProfileHash && X.ProfileHash != IDHash)
+      return false;
+    X.Profile(TempID, Context);
+    X.ProfileHash = TempID.ComputeHash();
+    return TempID == ID;
+  }
+
+  static unsigned ComputeHash(T &X, llvm::FoldingSetNodeID &TempID,
+                              ASTContext &Context) {
+    if (!X.ProfileHash) {
+      X.Profile(TempID, Context);
+      X.ProfileHash = TempID.ComputeHash();
+    }
+    return X.ProfileHash;
+  }
+};
 
 }  // end namespace clang
 
+namespace llvm {
+template <>
+struct ContextualFoldingSetTrait<clang::FunctionProtoType, clang::ASTContext &>
+    : clang::CachedProfileHashFoldingSetTrait<clang::FunctionProtoType> {};
+template <>
+struct ContextualFoldingSetTrait<clang::TemplateSpecializationType,
+                                 clang::ASTContext &>
+    : clang::CachedProfileHashFoldingSetTrait<
+          clang::TemplateSpecializationType> {};
+template <>
+struct ContextualFoldingSetTrait<clang::DependentTemplateSpecializationType,
+                                 clang::ASTContext &>
+    : clang::CachedProfileHashFoldingSetTrait<
+          clang::DependentTemplateSpecializationType> {};
+}  // end namespace llvm
+
 #endif
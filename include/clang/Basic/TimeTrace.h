@@ -0,0 +1,113 @@
+//===--- TimeTrace.h - Hierarchical Time Trace Profiler ---------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief Defines a lightweight profiler that records nested, timestamped
+/// scopes of compiler work and writes them out in the Chrome trace event
+/// format, which can be viewed with chrome://tracing or speedscope.
+///
+/// The profiler is disabled unless timeTraceProfilerInitialize() has been
+/// called on the current thread; a disabled TimeTraceScope costs a single
+/// load and branch.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_BASIC_TIMETRACE_H
+#define LLVM_CLANG_BASIC_TIMETRACE_H
+
+#include "clang/Basic/LLVM.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Compiler.h"
+#include <string>
+
+namespace clang {
+
+class TimeTraceProfiler;
+
+/// \brief The profiler of the current thread, or null if profiling is
+/// disabled.
+extern LLVM_THREAD_LOCAL TimeTraceProfiler *TimeTraceProfilerInstance;
+
+/// \brief The tracks onto which time trace events are recorded.
+///
+/// Events on a single track must be properly nested. Work whose extent does
+/// not nest with the rest of the compilation (such as the lexing of a header,
+/// which the parser may leave while it is in the middle of a declaration)
+/// is recorded on a separate track.
+enum TimeTraceTrack {
+  /// \brief Parsing, semantic analysis, code generation and the backend.
+  TTT_Compiler,
+  /// \brief Lexing of each source file.
+  TTT_Source,
+  TTT_NumTracks
+};
+
+/// \brief Enable the time trace profiler on the current thread.
+///
+/// \param GranularityMicroseconds Events that are shorter than this are not
+/// recorded, to keep the size of the trace manageable.
+void timeTraceProfilerInitialize(unsigned GranularityMicroseconds);
+
+/// \brief Disable the time trace profiler on the current thread and discard
+/// everything that has been recorded.
+void timeTraceProfilerCleanup();
+
+/// \brief Write the events recorded on the current thread as Chrome trace
+/// JSON to \p OS.
+void timeTraceProfilerWrite(raw_ostream &OS);
+
+/// \brief Determine whether the time trace profiler is enabled on the current
+/// thread.
+inline bool timeTraceProfilerEnabled() {
+  return TimeTraceProfilerInstance != nullptr;
+}
+
+/// \brief Start recording an event named \p Name on \p Track.
+///
+/// \param Detail The entity the work is performed for, such as a file name
+/// or the name of a template specialization.
+void timeTraceProfilerBegin(StringRef Name, StringRef Detail,
+                            TimeTraceTrack Track = TTT_Compiler);
+
+/// \brief Finish the innermost event on \p Track.
+void timeTraceProfilerEnd(TimeTraceTrack Track = TTT_Compiler);
+
+/// \brief RAII object that records an event for its lifetime, if the time
+/// trace profiler is enabled.
+class TimeTraceScope {
+  bool Active;
+
+public:
+  explicit TimeTraceScope(StringRef Name)
+      : Active(timeTraceProfilerEnabled()) {
+    if (Active)
+      timeTraceProfilerBegin(Name, StringRef());
+  }
+
+  /// \param Detail Computes the detail of the event; only called if the
+  /// profiler is enabled.
+  TimeTraceScope(StringRef Name, llvm::function_ref<std::string()> Detail)
+      : Active(timeTraceProfilerEnabled()) {
+    if (Active)
+      timeTraceProfilerBegin(Name, Detail());
+  }
+
+  ~TimeTraceScope() {
+    if (Active)
+      timeTraceProfilerEnd();
+  }
+
+  TimeTraceScope(const TimeTraceScope &) = delete;
+  TimeTraceScope &operator=(const TimeTraceScope &) = delete;
+};
+
+} // end namespace clang
+
+#endif
@@ -142,6 +142,15 @@ public:
   /// in the backend for setting the name in the skeleton cu.
   std::string SplitDwarfFile;
 
+  /// The object files to write the additional partitions of the module to,
+  /// when the code generator runs on several partitions in parallel. The
+  /// first partition is written to the main output.
+  std::vector<std::string> SplitCodeGenOutputs;
+
+  /// The names of the split debug info files of the additional partitions,
+  /// in the same order as SplitCodeGenOutputs.
+  std::vector<std::string> SplitCodeGenDwarfFiles;
+
   /// The name of the relocation model to use.
   std::string RelocationModel;
 
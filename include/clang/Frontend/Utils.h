@@ -33,6 +33,7 @@ class ArgList;
 
 namespace clang {
 class ASTConsumer;
+class ASTContext;
 class ASTReader;
 class CompilerInstance;
 class CompilerInvocation;
@@ -173,6 +174,13 @@ void AttachHeaderIncludeGen(Preprocessor &PP,
 /// Cache tokens for use with PCH. Note that this requires a seekable stream.
 void CacheTokens(Preprocessor &PP, raw_pwrite_stream *OS);
 
+/// \brief Write a breakdown of the memory used by the AST in \p Context to
+/// \p OS as JSON: by declaration, statement and type kind, by the source file
+/// that declarations and their bodies come from, and by whether they were
+/// written in the source, instantiated from a template, created implicitly
+/// or deserialized from an AST file.
+void PrintASTMemoryStats(ASTContext &Context, raw_ostream &OS);
+
 /// The ChainedIncludesSource class converts headers to chained PCHs in
 /// memory, mainly for testing.
 IntrusiveRefCntPtr<ExternalSemaSource>
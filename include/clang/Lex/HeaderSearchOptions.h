@@ -178,6 +178,19 @@ public:
 
   unsigned ModulesValidateDiagnosticOptions : 1;
 
+  /// \brief Whether AST files should be written such that identical inputs
+  /// produce identical files, regardless of when and where they are built.
+  ///
+  /// This omits timestamps and the output directory from the AST file, and
+  /// replaces the random signature of implicitly-built modules by a hash of
+  /// the module file itself and of its input files.
+  unsigned ReproducibleASTFiles : 1;
+
+  /// \brief If non-empty, the directory of a module that lies below this
+  /// directory is written to the module file relative to it, and relative
+  /// module directories read from module files are resolved against it.
+  std::string ASTFilePathRoot;
+
   HeaderSearchOptions(StringRef _Sysroot = "/")
       : Sysroot(_Sysroot), ModuleFormat("raw"), DisableModuleHash(0),
         ImplicitModuleMaps(0), ModuleMapFileHomeIsCwd(0),
@@ -187,7 +200,8 @@ public:
         UseStandardCXXIncludes(true), UseLibcxx(false), Verbose(false),
         ModulesValidateOncePerBuildSession(false),
         ModulesValidateSystemHeaders(false),
-        UseDebugInfo(false), ModulesValidateDiagnosticOptions(true) {}
+        UseDebugInfo(false), ModulesValidateDiagnosticOptions(true),
+        ReproducibleASTFiles(false) {}
 
   /// AddPath - Add the \p Path path to the specified \p Group list.
   void AddPath(StringRef Path, frontend::IncludeDirGroup Group,
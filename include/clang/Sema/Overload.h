@@ -245,6 +245,16 @@ namespace clang {
     void dump() const;
   };
 
+  /// \brief The result of a standard conversion check that has been cached
+  /// by Sema, since it does not depend on the source expression.
+  struct CachedStandardConversion {
+    /// The conversion sequence, if the conversion is possible.
+    StandardConversionSequence SCS;
+
+    /// Whether there is a standard conversion between the types.
+    bool Success;
+  };
+
   /// UserDefinedConversionSequence - Represents a user-defined
   /// conversion sequence (C++ 13.3.3.1.2).
   struct UserDefinedConversionSequence {
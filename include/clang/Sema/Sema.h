@@ -77,6 +77,7 @@ namespace clang {
   class AttributeList;
   class BindingDecl;
   class BlockDecl;
+  struct CachedStandardConversion;
   class CapturedDecl;
   class CXXBasePath;
   class CXXBasePaths;
@@ -116,6 +117,7 @@ namespace clang {
   class ExtVectorType;
   class FormatAttr;
   class FriendDecl;
+  struct FunctionBodyArena;
   class FunctionDecl;
   class FunctionProtoType;
   class FunctionTemplateDecl;
@@ -470,6 +472,10 @@ public:
   /// that's used to parse every top-level function.
   SmallVector<sema::FunctionScopeInfo *, 4> FunctionScopes;
 
+  /// \brief The function body arena that was active when each of the
+  /// function scopes above the first one was pushed.
+  SmallVector<FunctionBodyArena *, 4> SavedFunctionBodyArenas;
+
   typedef LazyVector<TypedefNameDecl *, ExternalSemaSource,
                      &ExternalSemaSource::ReadExtVectorDecls, 2, 2>
     ExtVectorDeclsType;
@@ -642,12 +648,14 @@ public:
     DeclContext *SavedContext;
     ProcessingContextState SavedContextState;
     QualType SavedCXXThisTypeOverride;
+    FunctionBodyArena *SavedBodyArena;
 
   public:
     ContextRAII(Sema &S, DeclContext *ContextToPush, bool NewThisContext = true)
       : S(S), SavedContext(S.CurContext),
         SavedContextState(S.DelayedDiagnostics.pushUndelayed()),
-        SavedCXXThisTypeOverride(S.CXXThisTypeOverride)
+        SavedCXXThisTypeOverride(S.CXXThisTypeOverride),
+        SavedBodyArena(S.suspendFunctionBodyArena())
     {
       assert(ContextToPush && "pushing null context");
       S.CurContext = ContextToPush;
@@ -660,6 +668,7 @@ public:
       S.CurContext = SavedContext;
       S.DelayedDiagnostics.popUndelayed(SavedContextState);
       S.CXXThisTypeOverride = SavedCXXThisTypeOverride;
+      S.restoreFunctionBodyArena(SavedBodyArena);
       SavedContext = nullptr;
     }
 
@@ -1202,6 +1211,24 @@ public:
                        const Decl *D = nullptr,
                        const BlockExpr *blkExpr = nullptr);
 
+  /// \brief Stop allocating statements in the arena of the function body
+  /// that is being built (see -ffree-function-bodies), for instance while
+  /// synthesizing or instantiating declarations that outlive it.
+  ///
+  /// \returns the arena, to be passed to restoreFunctionBodyArena().
+  FunctionBodyArena *suspendFunctionBodyArena();
+  void restoreFunctionBodyArena(FunctionBodyArena *Arena);
+
+  /// \brief Keep the statements of the function body that is being built
+  /// alive for as long as the AST, because something outside of the body may
+  /// refer to them.
+  void retainFunctionBody();
+
+  /// \brief Determine whether the statements in the body of \p FD can be
+  /// allocated in an arena that is released once code has been generated for
+  /// the function.
+  bool isReleasableFunctionBody(const FunctionDecl *FD) const;
+
   sema::FunctionScopeInfo *getCurFunction() const {
     return FunctionScopes.back();
   }
@@ -2326,6 +2353,23 @@ public:
   /// an available function, false otherwise.
   bool isFunctionConsideredUnavailable(FunctionDecl *FD);
 
+  /// \brief Identifies a standard conversion check by the source and target
+  /// types and the flags that can affect its outcome.
+  typedef std::pair<std::pair<void *, void *>, unsigned> StandardConversionKey;
+
+  /// \brief The standard conversions between arithmetic types and pointers
+  /// to them that have been checked so far, which only depend on the types
+  /// involved. Overload resolution for heavily overloaded functions checks
+  /// the same conversions over and over again. Created on first use.
+  std::unique_ptr<
+      llvm::DenseMap<StandardConversionKey, CachedStandardConversion>>
+      StandardConversionCache;
+
+  /// \brief The number of cacheable standard conversion checks, and the
+  /// number of those that were found in \c StandardConversionCache.
+  unsigned NumStandardConversionLookups = 0;
+  unsigned NumStandardConversionCacheHits = 0;
+
   ImplicitConversionSequence
   TryImplicitConversion(Expr *From, QualType ToType,
                         bool SuppressUserConversions,
@@ -7121,6 +7165,7 @@ public:
     bool Invalid;
     bool AlreadyInstantiating;
     bool SavedInNonInstantiationSFINAEContext;
+    FunctionBodyArena *SavedBodyArena;
     bool CheckInstantiationDepth(SourceLocation PointOfInstantiation,
                                  SourceRange InstantiationRange);
 
@@ -7248,6 +7293,12 @@ public:
   /// but have not yet been performed.
   std::deque<PendingImplicitInstantiation> PendingInstantiations;
 
+  /// \brief Implicit instantiations that were required while building a
+  /// translation unit prefix (such as a PCH) but whose templates have not
+  /// been defined yet. They are left to the translation units that use the
+  /// prefix, which may provide the definitions.
+  SmallVector<PendingImplicitInstantiation, 4> DeferredPrefixInstantiations;
+
   class SavePendingInstantiationsAndVTableUsesRAII {
   public:
     SavePendingInstantiationsAndVTableUsesRAII(Sema &S, bool Enabled)
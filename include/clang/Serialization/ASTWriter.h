@@ -106,6 +106,13 @@ private:
   /// \brief The bitstream writer used to emit this precompiled header.
   llvm::BitstreamWriter &Stream;
 
+  /// \brief The buffer associated with the bitstream.
+  const SmallVectorImpl<char> &Buffer;
+
+  /// \brief The bit offset of the placeholder for the signature of a module
+  /// whose signature is a hash of its contents, or 0 if there is none.
+  uint64_t SignatureOffset = 0;
+
   /// \brief The ASTContext we're writing.
   ASTContext *Context = nullptr;
 
@@ -498,8 +505,8 @@ private:
 
 public:
   /// \brief Create a new precompiled header writer that outputs to
-  /// the given bitstream.
-  ASTWriter(llvm::BitstreamWriter &Stream,
+  /// the given bitstream, which writes to \p Buffer.
+  ASTWriter(llvm::BitstreamWriter &Stream, SmallVectorImpl<char> &Buffer,
             ArrayRef<std::shared_ptr<ModuleFileExtension>> Extensions,
             bool IncludeTimestamps = true);
   ~ASTWriter() override;
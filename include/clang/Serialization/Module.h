@@ -165,7 +165,10 @@ public:
   
   /// \brief The memory buffer that stores the data associated with
   /// this AST file.
-  std::unique_ptr<llvm::MemoryBuffer> Buffer;
+  ///
+  /// Buffers of module files read from a file system are immutable and shared
+  /// with every other ModuleManager in the process that loads the same file.
+  std::shared_ptr<llvm::MemoryBuffer> Buffer;
 
   /// \brief The size of this file, in bits.
   uint64_t SizeInBits;
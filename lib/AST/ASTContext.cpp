@@ -13,6 +13,7 @@
 
 #include "clang/AST/ASTContext.h"
 #include "CXXABI.h"
+#include "ConstexprBytecode.h"
 #include "clang/AST/ASTMutationListener.h"
 #include "clang/AST/Attr.h"
 #include "clang/AST/CharUnits.h"
@@ -756,6 +757,13 @@ ASTContext::ASTContext(LangOptions &LOpts, SourceManager &SM,
   TUDecl = TranslationUnitDecl::Create(*this);
 }
 
+ConstexprBytecodeCache &ASTContext::getConstexprBytecodeCache() const {
+  if (!ConstexprBytecode)
+    ConstexprBytecode.reset(
+        new ConstexprBytecodeCache(const_cast<ASTContext &>(*this)));
+  return *ConstexprBytecode;
+}
+
 ASTContext::~ASTContext() {
   ReleaseParentMapEntries();
 
@@ -874,6 +882,16 @@ void ASTContext::PrintStats() const {
                << NumImplicitDestructors
                << " implicit destructors created\n";
 
+  if (getLangOpts().FreeFunctionBodies)
+    llvm::errs() << NumReleasedFunctionBodies << " function bodies released, "
+                 << ReleasedFunctionBodyMemory << " bytes freed\n";
+
+  llvm::errs() << "\n*** Lookup Table Stats:\n";
+  StoredDeclsMap::PrintStats(LastSDM.getPointer());
+
+  if (ConstexprBytecode)
+    ConstexprBytecode->PrintStats();
+
   if (ExternalSource) {
     llvm::errs() << "\n";
     ExternalSource->PrintStats();
@@ -882,6 +900,49 @@ void ASTContext::PrintStats() const {
   BumpAlloc.PrintStats();
 }
 
+size_t ASTContext::getASTAllocatedMemory() const {
+  size_t Bytes = BumpAlloc.getTotalMemory();
+  for (const auto &Arena : FunctionBodyArenas)
+    Bytes += Arena.second->Allocator.getTotalMemory();
+  for (const auto &Arena : RetainedBodyArenas)
+    Bytes += Arena->Allocator.getTotalMemory();
+  return Bytes;
+}
+
+FunctionBodyArena *ASTContext::createFunctionBodyArena(const FunctionDecl *FD) {
+  std::unique_ptr<FunctionBodyArena> &Arena = FunctionBodyArenas[FD];
+  // The body of a function that is defined again is still referred to by
+  // the first definition; keep it alive.
+  if (Arena)
+    RetainedBodyArenas.push_back(std::move(Arena));
+  Arena.reset(new FunctionBodyArena);
+  return Arena.get();
+}
+
+bool ASTContext::releaseFunctionBody(const FunctionDecl *FD) {
+  const FunctionDecl *Definition;
+  if (!FD->isDefined(Definition))
+    return false;
+
+  auto Known = FunctionBodyArenas.find(Definition);
+  if (Known == FunctionBodyArenas.end() || Known->second->Retained ||
+      Known->second.get() == ActiveBodyArena)
+    return false;
+
+  // Replace the body with an empty one that spans the same source range,
+  // allocated outside of any function body arena.
+  Stmt *Body = Definition->getBody();
+  void *Mem = BumpAlloc.Allocate(sizeof(CompoundStmt), alignof(CompoundStmt));
+  const_cast<FunctionDecl *>(Definition)
+      ->setBody(new (Mem) CompoundStmt(*this, None, Body->getLocStart(),
+                                       Body->getLocEnd()));
+
+  ++NumReleasedFunctionBodies;
+  ReleasedFunctionBodyMemory += Known->second->Allocator.getTotalMemory();
+  FunctionBodyArenas.erase(Known);
+  return true;
+}
+
 void ASTContext::mergeDefinitionIntoModule(NamedDecl *ND, Module *M,
                                            bool NotifyListeners) {
   if (NotifyListeners)
@@ -0,0 +1,1141 @@
+//===--- ConstexprBytecode.cpp - Bytecode for constexpr functions ---------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the compiler from constexpr function bodies to
+// bytecode, and the interpreter for that bytecode.
+//
+// Every local variable, parameter and intermediate value of a function gets a
+// register of the width of its type; a call pushes a frame of registers onto
+// a single stack shared by all calls. The interpreter is deliberately strict:
+// whenever the result of an operation is not a well-defined constant, it
+// gives up and leaves the call to the tree walker in ExprConstant.cpp, which
+// then produces the appropriate diagnostics. It must therefore never succeed
+// where the tree walker would fail.
+//
+//===----------------------------------------------------------------------===//
+
+#include "ConstexprBytecode.h"
+#include "clang/AST/APValue.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/Decl.h"
+#include "clang/AST/DeclCXX.h"
+#include "clang/AST/Expr.h"
+#include "clang/AST/ExprCXX.h"
+#include "clang/AST/Stmt.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace clang;
+using llvm::APInt;
+
+namespace clang {
+namespace bytecode {
+
+enum Opcode : uint8_t {
+  OP_Const,       ///< Dst = Constants[A]
+  OP_Move,        ///< Dst = A
+  OP_Add,         ///< Dst = A + B
+  OP_Sub,         ///< Dst = A - B
+  OP_Mul,         ///< Dst = A * B
+  OP_Div,         ///< Dst = A / B
+  OP_Rem,         ///< Dst = A % B
+  OP_Shl,         ///< Dst = A << B
+  OP_Shr,         ///< Dst = A >> B
+  OP_And,         ///< Dst = A & B
+  OP_Or,          ///< Dst = A | B
+  OP_Xor,         ///< Dst = A ^ B
+  OP_EQ,          ///< Dst = A == B
+  OP_NE,          ///< Dst = A != B
+  OP_LT,          ///< Dst = A < B
+  OP_LE,          ///< Dst = A <= B
+  OP_GT,          ///< Dst = A > B
+  OP_GE,          ///< Dst = A >= B
+  OP_Neg,         ///< Dst = -A
+  OP_Not,         ///< Dst = ~A
+  OP_LNot,        ///< Dst = !A
+  OP_Cast,        ///< Dst = A, extended or truncated to the width of Dst
+  OP_Jump,        ///< Continue at instruction A
+  OP_JumpIfFalse, ///< Continue at instruction A if B is zero
+  OP_JumpIfTrue,  ///< Continue at instruction A if B is non-zero
+  OP_Call,        ///< Dst = Callees[A](B, B + 1, ...)
+  OP_Ret,         ///< Return A
+  OP_Step,        ///< Consume A evaluation steps
+  OP_Fail         ///< Give up
+};
+
+/// \brief A single bytecode instruction.
+struct Instruction {
+  Opcode Op;
+  /// \brief Whether operand A (and, except for shifts, operand B) is signed.
+  bool Signed;
+  /// \brief Whether operand B of a shift is signed.
+  bool SignedB;
+  unsigned Dst;
+  unsigned A;
+  unsigned B;
+};
+
+/// \brief The bytecode of a single function.
+struct Function {
+  std::vector<Instruction> Code;
+  std::vector<APInt> Constants;
+  std::vector<const FunctionDecl *> Callees;
+  /// \brief The width of each register; parameters come first.
+  std::vector<unsigned> RegisterWidths;
+  unsigned NumParams;
+  bool ReturnsSigned;
+};
+
+} // end namespace bytecode
+} // end namespace clang
+
+using namespace clang::bytecode;
+
+/// \brief Determine whether the bytecode can represent values of type \p T.
+static bool isSupportedType(QualType T) {
+  return T->isIntegralOrEnumerationType();
+}
+
+namespace {
+
+/// \brief Compiles the body of a single function to bytecode.
+class BytecodeCompiler {
+  ASTContext &Ctx;
+  Function &F;
+
+  /// \brief The registers holding each parameter and local variable.
+  llvm::DenseMap<const ValueDecl *, unsigned> Locals;
+
+  /// \brief The jumps that a break or continue statement must be patched to
+  /// go to, for each enclosing loop or switch.
+  struct BreakScope {
+    bool IsLoop;
+    SmallVector<unsigned, 4> Breaks;
+    SmallVector<unsigned, 4> Continues;
+  };
+  SmallVector<BreakScope, 4> BreakScopes;
+
+  /// \brief The instruction each case label of the enclosing switches starts
+  /// at, once it has been compiled.
+  llvm::DenseMap<const SwitchCase *, unsigned> CaseTargets;
+
+  /// \brief A register number that is never valid.
+  enum : unsigned { NoReg = ~0U };
+
+  unsigned emit(Opcode Op, unsigned Dst = 0, unsigned A = 0, unsigned B = 0,
+                bool Signed = false, bool SignedB = false) {
+    Instruction I = {Op, Signed, SignedB, Dst, A, B};
+    F.Code.push_back(I);
+    return F.Code.size() - 1;
+  }
+
+  unsigned here() const { return F.Code.size(); }
+
+  void patch(unsigned Jump, unsigned Target) { F.Code[Jump].A = Target; }
+
+  unsigned newRegister(QualType T) {
+    F.RegisterWidths.push_back(Ctx.getIntWidth(T));
+    return F.RegisterWidths.size() - 1;
+  }
+
+  unsigned emitConstant(const APInt &Value, QualType T) {
+    unsigned Reg = newRegister(T);
+    F.Constants.push_back(Value.zextOrTrunc(Ctx.getIntWidth(T)));
+    emit(OP_Const, Reg, F.Constants.size() - 1);
+    return Reg;
+  }
+
+  /// \brief Convert the value in \p Reg from type \p From to type \p To.
+  unsigned emitConversion(unsigned Reg, QualType From, QualType To) {
+    if (To->isBooleanType() && !From->isBooleanType()) {
+      unsigned Zero = emitConstant(APInt(Ctx.getIntWidth(From), 0), From);
+      unsigned Result = newRegister(To);
+      emit(OP_NE, Result, Reg, Zero);
+      return Result;
+    }
+    if (Ctx.getIntWidth(From) == Ctx.getIntWidth(To))
+      return Reg;
+    unsigned Result = newRegister(To);
+    emit(OP_Cast, Result, Reg, 0, From->isSignedIntegerOrEnumerationType());
+    return Result;
+  }
+
+  bool compileStmt(const Stmt *S);
+  bool compileSwitch(const SwitchStmt *SS);
+  bool compileDiscarded(const Expr *E);
+  unsigned compileRValue(const Expr *E);
+  unsigned compileLValue(const Expr *E);
+  unsigned compileBinaryOperator(const BinaryOperator *BO);
+  unsigned compileIncDec(const UnaryOperator *UO);
+  unsigned compileAssignment(const BinaryOperator *BO);
+  unsigned compileCall(const CallExpr *CE);
+
+public:
+  BytecodeCompiler(ASTContext &Ctx, Function &F) : Ctx(Ctx), F(F) {}
+
+  bool compile(const FunctionDecl *FD, const Stmt *Body);
+};
+
+} // end anonymous namespace
+
+bool BytecodeCompiler::compile(const FunctionDecl *FD, const Stmt *Body) {
+  if (FD->isVariadic() || !isSupportedType(FD->getReturnType()))
+    return false;
+  if (const auto *MD = dyn_cast<CXXMethodDecl>(FD))
+    if (MD->isInstance())
+      return false;
+
+  F.NumParams = FD->getNumParams();
+  F.ReturnsSigned = FD->getReturnType()->isSignedIntegerOrEnumerationType();
+  for (const ParmVarDecl *PVD : FD->parameters()) {
+    if (!isSupportedType(PVD->getType()))
+      return false;
+    Locals[PVD] = newRegister(PVD->getType());
+  }
+
+  if (!compileStmt(Body))
+    return false;
+
+  // Falling off the end of a function that returns a value is not a
+  // constant expression.
+  emit(OP_Fail);
+  return true;
+}
+
+/// \brief Count the evaluation steps the tree walker takes in \p S while
+/// looking for the label \p Case of the enclosing switch, including the step
+/// for the label itself.
+///
+/// \param Found Set to true once the label has been reached.
+static unsigned countStepsToCase(const Stmt *S, const SwitchCase *Case,
+                                 bool &Found) {
+  unsigned Steps = 1;
+  switch (S->getStmtClass()) {
+  case Stmt::CompoundStmtClass:
+    for (const Stmt *Child : cast<CompoundStmt>(S)->body()) {
+      Steps += countStepsToCase(Child, Case, Found);
+      if (Found)
+        break;
+    }
+    return Steps;
+
+  case Stmt::CaseStmtClass:
+  case Stmt::DefaultStmtClass:
+    if (S == Case) {
+      Found = true;
+      return Steps;
+    }
+    return Steps +
+           countStepsToCase(cast<SwitchCase>(S)->getSubStmt(), Case, Found);
+
+  case Stmt::IfStmtClass: {
+    const auto *IS = cast<IfStmt>(S);
+    Steps += countStepsToCase(IS->getThen(), Case, Found);
+    if (!Found && IS->getElse())
+      Steps += countStepsToCase(IS->getElse(), Case, Found);
+    return Steps;
+  }
+
+  case Stmt::WhileStmtClass:
+    return Steps + countStepsToCase(cast<WhileStmt>(S)->getBody(), Case, Found);
+  case Stmt::DoStmtClass:
+    return Steps + countStepsToCase(cast<DoStmt>(S)->getBody(), Case, Found);
+  case Stmt::ForStmtClass:
+    return Steps + countStepsToCase(cast<ForStmt>(S)->getBody(), Case, Found);
+
+  default:
+    return Steps;
+  }
+}
+
+bool BytecodeCompiler::compileStmt(const Stmt *S) {
+  if (!S)
+    return true;
+
+  // Account for the evaluation step the tree walker takes for every
+  // statement.
+  emit(OP_Step, 0, 1);
+
+  if (const auto *E = dyn_cast<Expr>(S))
+    return compileDiscarded(E);
+
+  switch (S->getStmtClass()) {
+  case Stmt::NullStmtClass:
+    return true;
+
+  case Stmt::CompoundStmtClass:
+    for (const Stmt *Child : cast<CompoundStmt>(S)->body())
+      if (!compileStmt(Child))
+        return false;
+    return true;
+
+  case Stmt::DeclStmtClass:
+    for (const Decl *D : cast<DeclStmt>(S)->decls()) {
+      if (isa<TypedefNameDecl>(D) || isa<StaticAssertDecl>(D))
+        continue;
+      const auto *VD = dyn_cast<VarDecl>(D);
+      if (!VD || !VD->hasLocalStorage() || !isSupportedType(VD->getType()) ||
+          !VD->getInit())
+        return false;
+      unsigned Init = compileRValue(VD->getInit());
+      if (Init == NoReg)
+        return false;
+      unsigned Reg = newRegister(VD->getType());
+      emit(OP_Move, Reg, Init);
+      Locals[VD] = Reg;
+    }
+    return true;
+
+  case Stmt::ReturnStmtClass: {
+    const Expr *RetExpr = cast<ReturnStmt>(S)->getRetValue();
+    if (!RetExpr)
+      return false;
+    unsigned Reg = compileRValue(RetExpr);
+    if (Reg == NoReg)
+      return false;
+    emit(OP_Ret, 0, Reg);
+    return true;
+  }
+
+  case Stmt::IfStmtClass: {
+    const auto *IS = cast<IfStmt>(S);
+    if (IS->getInit() || IS->getConditionVariable())
+      return false;
+    unsigned Cond = compileRValue(IS->getCond());
+    if (Cond == NoReg)
+      return false;
+    unsigned ToElse = emit(OP_JumpIfFalse, 0, 0, Cond);
+    if (!compileStmt(IS->getThen()))
+      return false;
+    if (!IS->getElse()) {
+      patch(ToElse, here());
+      return true;
+    }
+    unsigned ToEnd = emit(OP_Jump);
+    patch(ToElse, here());
+    if (!compileStmt(IS->getElse()))
+      return false;
+    patch(ToEnd, here());
+    return true;
+  }
+
+  case Stmt::WhileStmtClass: {
+    const auto *WS = cast<WhileStmt>(S);
+    if (WS->getConditionVariable())
+      return false;
+    unsigned Start = here();
+    unsigned Cond = compileRValue(WS->getCond());
+    if (Cond == NoReg)
+      return false;
+    unsigned ToEnd = emit(OP_JumpIfFalse, 0, 0, Cond);
+    BreakScopes.push_back({/*IsLoop=*/true, {}, {}});
+    if (!compileStmt(WS->getBody()))
+      return false;
+    emit(OP_Jump, 0, Start);
+    BreakScope Scope = BreakScopes.pop_back_val();
+    for (unsigned Continue : Scope.Continues)
+      patch(Continue, Start);
+    patch(ToEnd, here());
+    for (unsigned Break : Scope.Breaks)
+      patch(Break, here());
+    return true;
+  }
+
+  case Stmt::DoStmtClass: {
+    const auto *DS = cast<DoStmt>(S);
+    unsigned Start = here();
+    BreakScopes.push_back({/*IsLoop=*/true, {}, {}});
+    if (!compileStmt(DS->getBody()))
+      return false;
+    BreakScope Scope = BreakScopes.pop_back_val();
+    for (unsigned Continue : Scope.Continues)
+      patch(Continue, here());
+    unsigned Cond = compileRValue(DS->getCond());
+    if (Cond == NoReg)
+      return false;
+    emit(OP_JumpIfTrue, 0, Start, Cond);
+    for (unsigned Break : Scope.Breaks)
+      patch(Break, here());
+    return true;
+  }
+
+  case Stmt::ForStmtClass: {
+    const auto *FS = cast<ForStmt>(S);
+    if (FS->getConditionVariable())
+      return false;
+    if (!compileStmt(FS->getInit()))
+      return false;
+    unsigned Start = here();
+    unsigned ToEnd = NoReg;
+    if (const Expr *CondExpr = FS->getCond()) {
+      unsigned Cond = compileRValue(CondExpr);
+      if (Cond == NoReg)
+        return false;
+      ToEnd = emit(OP_JumpIfFalse, 0, 0, Cond);
+    }
+    BreakScopes.push_back({/*IsLoop=*/true, {}, {}});
+    if (!compileStmt(FS->getBody()))
+      return false;
+    BreakScope Scope = BreakScopes.pop_back_val();
+    for (unsigned Continue : Scope.Continues)
+      patch(Continue, here());
+    if (FS->getInc() && !compileDiscarded(FS->getInc()))
+      return false;
+    emit(OP_Jump, 0, Start);
+    if (ToEnd != NoReg)
+      patch(ToEnd, here());
+    for (unsigned Break : Scope.Breaks)
+      patch(Break, here());
+    return true;
+  }
+
+  case Stmt::BreakStmtClass:
+    if (BreakScopes.empty())
+      return false;
+    BreakScopes.back().Breaks.push_back(emit(OP_Jump));
+    return true;
+
+  case Stmt::ContinueStmtClass:
+    for (auto I = BreakScopes.rbegin(), E = BreakScopes.rend(); I != E; ++I) {
+      if (I->IsLoop) {
+        I->Continues.push_back(emit(OP_Jump));
+        return true;
+      }
+    }
+    return false;
+
+  case Stmt::SwitchStmtClass:
+    return compileSwitch(cast<SwitchStmt>(S));
+
+  case Stmt::CaseStmtClass:
+  case Stmt::DefaultStmtClass: {
+    const auto *SC = cast<SwitchCase>(S);
+    auto Target = CaseTargets.find(SC);
+    if (Target == CaseTargets.end())
+      return false;
+    Target->second = here();
+    return compileStmt(SC->getSubStmt());
+  }
+
+  default:
+    return false;
+  }
+}
+
+bool BytecodeCompiler::compileSwitch(const SwitchStmt *SS) {
+  if (SS->getInit() || SS->getConditionVariable())
+    return false;
+  const Expr *CondExpr = SS->getCond();
+  unsigned Cond = compileRValue(CondExpr);
+  if (Cond == NoReg)
+    return false;
+
+  struct CaseJump {
+    const SwitchCase *Case;
+    unsigned Jump;
+  };
+  SmallVector<CaseJump, 16> Jumps;
+  const SwitchCase *Default = nullptr;
+
+  // The tree walker steps through the body up to the selected label; charge
+  // for those steps before jumping to it.
+  auto EmitStepsToCase = [&](const SwitchCase *SC) {
+    bool Found = false;
+    emit(OP_Step, 0, countStepsToCase(SS->getBody(), SC, Found));
+  };
+
+  for (const SwitchCase *SC = SS->getSwitchCaseList(); SC;
+       SC = SC->getNextSwitchCase()) {
+    CaseTargets[SC] = NoReg;
+    if (isa<DefaultStmt>(SC)) {
+      Default = SC;
+      continue;
+    }
+    const auto *CS = cast<CaseStmt>(SC);
+    if (CS->getRHS())
+      return false; // GNU case ranges.
+    llvm::APSInt Value;
+    if (!CS->getLHS()->EvaluateAsInt(Value, Ctx))
+      return false;
+    Value = Value.extOrTrunc(Ctx.getIntWidth(CondExpr->getType()));
+    unsigned Label = emitConstant(Value, CondExpr->getType());
+    unsigned Matches = newRegister(Ctx.BoolTy);
+    emit(OP_EQ, Matches, Cond, Label);
+    unsigned ToNext = emit(OP_JumpIfFalse, 0, 0, Matches);
+    EmitStepsToCase(SC);
+    Jumps.push_back({SC, emit(OP_Jump)});
+    patch(ToNext, here());
+  }
+  if (Default)
+    EmitStepsToCase(Default);
+  unsigned ToDefault = emit(OP_Jump);
+
+  BreakScopes.push_back({/*IsLoop=*/false, {}, {}});
+  if (!compileStmt(SS->getBody()))
+    return false;
+  BreakScope Scope = BreakScopes.pop_back_val();
+
+  // A case label that was not reached while compiling the body (for
+  // instance, one nested inside a statement we do not support) cannot be
+  // jumped to.
+  for (const CaseJump &J : Jumps) {
+    unsigned Target = CaseTargets[J.Case];
+    if (Target == NoReg)
+      return false;
+    patch(J.Jump, Target);
+  }
+  if (Default) {
+    unsigned Target = CaseTargets[Default];
+    if (Target == NoReg)
+      return false;
+    patch(ToDefault, Target);
+  } else {
+    patch(ToDefault, here());
+  }
+  for (unsigned Break : Scope.Breaks)
+    patch(Break, here());
+  return true;
+}
+
+bool BytecodeCompiler::compileDiscarded(const Expr *E) {
+  if (E->isGLValue())
+    return compileLValue(E) != NoReg;
+  if (E->getType()->isVoidType()) {
+    // Allow explicitly discarding a value with a cast to void.
+    const auto *CE = dyn_cast<CastExpr>(E->IgnoreParens());
+    if (!CE || CE->getCastKind() != CK_ToVoid)
+      return false;
+    return compileDiscarded(CE->getSubExpr());
+  }
+  return compileRValue(E) != NoReg;
+}
+
+unsigned BytecodeCompiler::compileLValue(const Expr *E) {
+  E = E->IgnoreParens();
+
+  if (const auto *DRE = dyn_cast<DeclRefExpr>(E)) {
+    auto Local = Locals.find(DRE->getDecl());
+    return Local == Locals.end() ? NoReg : Local->second;
+  }
+
+  if (const auto *UO = dyn_cast<UnaryOperator>(E)) {
+    if (UO->getOpcode() == UO_PreInc || UO->getOpcode() == UO_PreDec)
+      return compileIncDec(UO);
+    return NoReg;
+  }
+
+  if (const auto *BO = dyn_cast<BinaryOperator>(E)) {
+    if (BO->getOpcode() == BO_Comma) {
+      if (!compileDiscarded(BO->getLHS()))
+        return NoReg;
+      return compileLValue(BO->getRHS());
+    }
+    if (BO->isAssignmentOp())
+      return compileAssignment(BO);
+    return NoReg;
+  }
+
+  return NoReg;
+}
+
+unsigned BytecodeCompiler::compileRValue(const Expr *E) {
+  if (!E->isRValue() || !isSupportedType(E->getType()))
+    return NoReg;
+
+  switch (E->getStmtClass()) {
+  case Stmt::ParenExprClass:
+    return compileRValue(cast<ParenExpr>(E)->getSubExpr());
+
+  case Stmt::IntegerLiteralClass:
+    return emitConstant(cast<IntegerLiteral>(E)->getValue(), E->getType());
+
+  case Stmt::CharacterLiteralClass:
+    return emitConstant(
+        Ctx.MakeIntValue(cast<CharacterLiteral>(E)->getValue(), E->getType()),
+        E->getType());
+
+  case Stmt::CXXBoolLiteralExprClass:
+    return emitConstant(APInt(1, cast<CXXBoolLiteralExpr>(E)->getValue()),
+                        E->getType());
+
+  case Stmt::SubstNonTypeTemplateParmExprClass:
+    return compileRValue(
+        cast<SubstNonTypeTemplateParmExpr>(E)->getReplacement());
+
+  case Stmt::CXXDefaultArgExprClass:
+    return compileRValue(cast<CXXDefaultArgExpr>(E)->getExpr());
+
+  case Stmt::DeclRefExprClass: {
+    const auto *ECD =
+        dyn_cast<EnumConstantDecl>(cast<DeclRefExpr>(E)->getDecl());
+    if (!ECD)
+      return NoReg;
+    return emitConstant(ECD->getInitVal(), E->getType());
+  }
+
+  case Stmt::UnaryExprOrTypeTraitExprClass: {
+    llvm::APSInt Value;
+    if (E->isValueDependent() || !E->EvaluateAsInt(Value, Ctx))
+      return NoReg;
+    return emitConstant(Value, E->getType());
+  }
+
+  case Stmt::ImplicitCastExprClass:
+  case Stmt::CStyleCastExprClass:
+  case Stmt::CXXFunctionalCastExprClass:
+  case Stmt::CXXStaticCastExprClass: {
+    const auto *CE = cast<CastExpr>(E);
+    const Expr *Sub = CE->getSubExpr();
+    switch (CE->getCastKind()) {
+    case CK_LValueToRValue: {
+      if (!isSupportedType(Sub->getType()) ||
+          Sub->getType().isVolatileQualified())
+        return NoReg;
+      unsigned Reg = compileLValue(Sub);
+      if (Reg == NoReg)
+        return NoReg;
+      // Copy the value, so that later changes to the variable do not affect
+      // it; the tree walker reads variables as it goes.
+      unsigned Copy = newRegister(E->getType());
+      emit(OP_Move, Copy, Reg);
+      return Copy;
+    }
+    case CK_NoOp:
+    case CK_IntegralCast:
+    case CK_IntegralToBoolean: {
+      if (!isSupportedType(Sub->getType()))
+        return NoReg;
+      unsigned Reg = compileRValue(Sub);
+      if (Reg == NoReg)
+        return NoReg;
+      return emitConversion(Reg, Sub->getType(), E->getType());
+    }
+    default:
+      return NoReg;
+    }
+  }
+
+  case Stmt::UnaryOperatorClass: {
+    const auto *UO = cast<UnaryOperator>(E);
+    if (UO->getOpcode() == UO_PostInc || UO->getOpcode() == UO_PostDec)
+      return compileIncDec(UO);
+
+    const Expr *Sub = UO->getSubExpr();
+    unsigned Reg = compileRValue(Sub);
+    if (Reg == NoReg)
+      return NoReg;
+    bool Signed = Sub->getType()->isSignedIntegerOrEnumerationType();
+    unsigned Result;
+    switch (UO->getOpcode()) {
+    case UO_Plus:
+      return Reg;
+    case UO_Minus:
+      Result = newRegister(E->getType());
+      emit(OP_Neg, Result, Reg, 0, Signed);
+      return Result;
+    case UO_Not:
+      Result = newRegister(E->getType());
+      emit(OP_Not, Result, Reg);
+      return Result;
+    case UO_LNot:
+      if (!Sub->getType()->isBooleanType())
+        return NoReg;
+      Result = newRegister(E->getType());
+      emit(OP_LNot, Result, Reg);
+      return Result;
+    default:
+      return NoReg;
+    }
+  }
+
+  case Stmt::BinaryOperatorClass:
+    return compileBinaryOperator(cast<BinaryOperator>(E));
+
+  case Stmt::ConditionalOperatorClass: {
+    const auto *CO = cast<ConditionalOperator>(E);
+    unsigned Cond = compileRValue(CO->getCond());
+    if (Cond == NoReg)
+      return NoReg;
+    unsigned Result = newRegister(E->getType());
+    unsigned ToFalse = emit(OP_JumpIfFalse, 0, 0, Cond);
+    unsigned True = compileRValue(CO->getTrueExpr());
+    if (True == NoReg)
+      return NoReg;
+    emit(OP_Move, Result, True);
+    unsigned ToEnd = emit(OP_Jump);
+    patch(ToFalse, here());
+    unsigned False = compileRValue(CO->getFalseExpr());
+    if (False == NoReg)
+      return NoReg;
+    emit(OP_Move, Result, False);
+    patch(ToEnd, here());
+    return Result;
+  }
+
+  case Stmt::CallExprClass:
+    return compileCall(cast<CallExpr>(E));
+
+  default:
+    return NoReg;
+  }
+}
+
+unsigned BytecodeCompiler::compileBinaryOperator(const BinaryOperator *BO) {
+  BinaryOperatorKind Opc = BO->getOpcode();
+  if (Opc == BO_Comma) {
+    if (!compileDiscarded(BO->getLHS()))
+      return NoReg;
+    return compileRValue(BO->getRHS());
+  }
+
+  const Expr *LHS = BO->getLHS();
+  const Expr *RHS = BO->getRHS();
+  if (!isSupportedType(LHS->getType()) || !isSupportedType(RHS->getType()))
+    return NoReg;
+
+  if (Opc == BO_LAnd || Opc == BO_LOr) {
+    unsigned Result = newRegister(BO->getType());
+    unsigned L = compileRValue(LHS);
+    if (L == NoReg)
+      return NoReg;
+    emit(OP_Move, Result, L);
+    unsigned ToEnd =
+        emit(Opc == BO_LAnd ? OP_JumpIfFalse : OP_JumpIfTrue, 0, 0, Result);
+    unsigned R = compileRValue(RHS);
+    if (R == NoReg)
+      return NoReg;
+    emit(OP_Move, Result, R);
+    patch(ToEnd, here());
+    return Result;
+  }
+
+  Opcode Op;
+  switch (Opc) {
+  case BO_Mul: Op = OP_Mul; break;
+  case BO_Div: Op = OP_Div; break;
+  case BO_Rem: Op = OP_Rem; break;
+  case BO_Add: Op = OP_Add; break;
+  case BO_Sub: Op = OP_Sub; break;
+  case BO_Shl: Op = OP_Shl; break;
+  case BO_Shr: Op = OP_Shr; break;
+  case BO_And: Op = OP_And; break;
+  case BO_Xor: Op = OP_Xor; break;
+  case BO_Or:  Op = OP_Or;  break;
+  case BO_EQ:  Op = OP_EQ;  break;
+  case BO_NE:  Op = OP_NE;  break;
+  case BO_LT:  Op = OP_LT;  break;
+  case BO_LE:  Op = OP_LE;  break;
+  case BO_GT:  Op = OP_GT;  break;
+  case BO_GE:  Op = OP_GE;  break;
+  default:
+    return NoReg;
+  }
+
+  // Apart from shifts, both operands have already been converted to a common
+  // type.
+  if (!BO->isShiftOp() &&
+      Ctx.getIntWidth(LHS->getType()) != Ctx.getIntWidth(RHS->getType()))
+    return NoReg;
+
+  unsigned L = compileRValue(LHS);
+  if (L == NoReg)
+    return NoReg;
+  unsigned R = compileRValue(RHS);
+  if (R == NoReg)
+    return NoReg;
+  unsigned Result = newRegister(BO->getType());
+  emit(Op, Result, L, R, LHS->getType()->isSignedIntegerOrEnumerationType(),
+       RHS->getType()->isSignedIntegerOrEnumerationType());
+  return Result;
+}
+
+unsigned BytecodeCompiler::compileIncDec(const UnaryOperator *UO) {
+  QualType T = UO->getSubExpr()->getType();
+  if (T->isBooleanType())
+    return NoReg;
+  unsigned Var = compileLValue(UO->getSubExpr());
+  if (Var == NoReg)
+    return NoReg;
+
+  unsigned Old = NoReg;
+  if (UO->isPostfix()) {
+    Old = newRegister(T);
+    emit(OP_Move, Old, Var);
+  }
+
+  // Increments of types narrower than int are performed after promotion, so
+  // they cannot overflow.
+  bool Signed = T->isSignedIntegerOrEnumerationType() &&
+                Ctx.getIntWidth(T) >= Ctx.getIntWidth(Ctx.IntTy);
+  unsigned One = emitConstant(APInt(Ctx.getIntWidth(T), 1), T);
+  emit(UO->isIncrementOp() ? OP_Add : OP_Sub, Var, Var, One, Signed, Signed);
+  return UO->isPostfix() ? Old : Var;
+}
+
+unsigned BytecodeCompiler::compileAssignment(const BinaryOperator *BO) {
+  const Expr *LHS = BO->getLHS();
+  QualType LHSType = LHS->getType();
+  if (!isSupportedType(LHSType))
+    return NoReg;
+
+  if (BO->getOpcode() == BO_Assign) {
+    unsigned Value = compileRValue(BO->getRHS());
+    if (Value == NoReg)
+      return NoReg;
+    unsigned Var = compileLValue(LHS);
+    if (Var == NoReg)
+      return NoReg;
+    emit(OP_Move, Var, Value);
+    return Var;
+  }
+
+  const auto *CAO = cast<CompoundAssignOperator>(BO);
+  QualType CompLHSType = CAO->getComputationLHSType();
+  QualType CompResultType = CAO->getComputationResultType();
+  const Expr *RHS = BO->getRHS();
+  if (!isSupportedType(CompLHSType) || !isSupportedType(CompResultType) ||
+      !isSupportedType(RHS->getType()))
+    return NoReg;
+
+  Opcode Op;
+  switch (BO->getOpcode()) {
+  case BO_MulAssign: Op = OP_Mul; break;
+  case BO_DivAssign: Op = OP_Div; break;
+  case BO_RemAssign: Op = OP_Rem; break;
+  case BO_AddAssign: Op = OP_Add; break;
+  case BO_SubAssign: Op = OP_Sub; break;
+  case BO_ShlAssign: Op = OP_Shl; break;
+  case BO_ShrAssign: Op = OP_Shr; break;
+  case BO_AndAssign: Op = OP_And; break;
+  case BO_XorAssign: Op = OP_Xor; break;
+  case BO_OrAssign:  Op = OP_Or;  break;
+  default:
+    return NoReg;
+  }
+  bool IsShift = Op == OP_Shl || Op == OP_Shr;
+  if (!IsShift &&
+      Ctx.getIntWidth(CompLHSType) != Ctx.getIntWidth(RHS->getType()))
+    return NoReg;
+
+  // The tree walker evaluates the right-hand side first.
+  unsigned R = compileRValue(RHS);
+  if (R == NoReg)
+    return NoReg;
+  unsigned Var = compileLValue(LHS);
+  if (Var == NoReg)
+    return NoReg;
+  unsigned L = emitConversion(Var, LHSType, CompLHSType);
+  unsigned Result = newRegister(CompResultType);
+  emit(Op, Result, L, R, CompLHSType->isSignedIntegerOrEnumerationType(),
+       RHS->getType()->isSignedIntegerOrEnumerationType());
+  unsigned Converted = emitConversion(Result, CompResultType, LHSType);
+  emit(OP_Move, Var, Converted);
+  return Var;
+}
+
+unsigned BytecodeCompiler::compileCall(const CallExpr *CE) {
+  const FunctionDecl *Callee = CE->getDirectCallee();
+  if (!Callee || Callee->getBuiltinID() || Callee->isVariadic() ||
+      !isSupportedType(Callee->getReturnType()) ||
+      CE->getNumArgs() != Callee->getNumParams())
+    return NoReg;
+  if (const auto *MD = dyn_cast<CXXMethodDecl>(Callee))
+    if (MD->isInstance())
+      return NoReg;
+
+  // Evaluate the arguments into consecutive registers, which become the
+  // parameters of the callee's frame.
+  SmallVector<unsigned, 8> Args;
+  for (unsigned I = 0, N = CE->getNumArgs(); I != N; ++I) {
+    QualType ParamType = Callee->getParamDecl(I)->getType();
+    const Expr *Arg = CE->getArg(I);
+    if (!isSupportedType(ParamType) ||
+        Ctx.getIntWidth(ParamType) != Ctx.getIntWidth(Arg->getType()))
+      return NoReg;
+    unsigned Reg = compileRValue(Arg);
+    if (Reg == NoReg)
+      return NoReg;
+    Args.push_back(Reg);
+  }
+  unsigned FirstArg = F.RegisterWidths.size();
+  for (unsigned I = 0, N = Args.size(); I != N; ++I)
+    emit(OP_Move, newRegister(Callee->getParamDecl(I)->getType()), Args[I]);
+
+  F.Callees.push_back(Callee);
+  unsigned Result = newRegister(CE->getType());
+  emit(OP_Call, Result, F.Callees.size() - 1, FirstArg);
+  return Result;
+}
+
+ConstexprBytecodeCache::ConstexprBytecodeCache(ASTContext &Ctx) : Ctx(Ctx) {}
+
+ConstexprBytecodeCache::~ConstexprBytecodeCache() {}
+
+const Function *
+ConstexprBytecodeCache::getFunction(const FunctionDecl *Definition) {
+  auto Known = Functions.find(Definition);
+  if (Known != Functions.end())
+    return Known->second.get();
+
+  // Insert a null entry first, so that the function is treated as
+  // unsupported if it is compiled recursively.
+  Functions[Definition] = nullptr;
+  std::unique_ptr<Function> F(new Function());
+  BytecodeCompiler Compiler(Ctx, *F);
+  if (!Compiler.compile(Definition, Definition->getBody()))
+    return nullptr;
+  return (Functions[Definition] = std::move(F)).get();
+}
+
+/// \brief Push a frame for a call to \p F with the argument values \p Args
+/// onto the stack.
+bool ConstexprBytecodeCache::pushFrame(const Function &F,
+                                       ArrayRef<APInt> Args) {
+  // Copy the arguments first, as they may live in the stack itself.
+  SmallVector<APInt, 8> Params(Args.begin(), Args.end());
+  unsigned Base = Stack.size();
+  Stack.resize(Base + F.RegisterWidths.size());
+  for (unsigned R = 0, N = F.RegisterWidths.size(); R != N; ++R) {
+    if (R < F.NumParams) {
+      if (Params[R].getBitWidth() != F.RegisterWidths[R]) {
+        Stack.resize(Base);
+        return false;
+      }
+      Stack[Base + R] = std::move(Params[R]);
+    } else {
+      Stack[Base + R] = APInt(F.RegisterWidths[R], 0);
+    }
+  }
+  return true;
+}
+
+bool ConstexprBytecodeCache::execute(const Function &F, unsigned FrameBase,
+                                     unsigned Depth, unsigned &StepsLeft,
+                                     APInt &Result) {
+  const Instruction *Code = F.Code.data();
+  for (unsigned PC = 0;;) {
+    const Instruction &I = Code[PC++];
+    APInt *Regs = Stack.data() + FrameBase;
+    switch (I.Op) {
+    case OP_Const:
+      Regs[I.Dst] = F.Constants[I.A];
+      break;
+
+    case OP_Move:
+      Regs[I.Dst] = Regs[I.A];
+      break;
+
+    case OP_Add:
+    case OP_Sub:
+    case OP_Mul: {
+      const APInt &L = Regs[I.A], &R = Regs[I.B];
+      if (I.Signed) {
+        bool Overflow = false;
+        APInt Value = I.Op == OP_Add
+                          ? L.sadd_ov(R, Overflow)
+                          : I.Op == OP_Sub ? L.ssub_ov(R, Overflow)
+                                           : L.smul_ov(R, Overflow);
+        if (Overflow)
+          return false;
+        Regs[I.Dst] = std::move(Value);
+      } else {
+        Regs[I.Dst] = I.Op == OP_Add ? L + R : I.Op == OP_Sub ? L - R : L * R;
+      }
+      break;
+    }
+
+    case OP_Div:
+    case OP_Rem: {
+      const APInt &L = Regs[I.A], &R = Regs[I.B];
+      if (R == 0)
+        return false;
+      if (I.Signed && L.isMinSignedValue() && R.isAllOnesValue())
+        return false;
+      if (I.Op == OP_Div)
+        Regs[I.Dst] = I.Signed ? L.sdiv(R) : L.udiv(R);
+      else
+        Regs[I.Dst] = I.Signed ? L.srem(R) : L.urem(R);
+      break;
+    }
+
+    case OP_Shl:
+    case OP_Shr: {
+      const APInt &L = Regs[I.A], &R = Regs[I.B];
+      unsigned Width = L.getBitWidth();
+      if ((I.SignedB && R.isNegative()) || R.uge(Width))
+        return false;
+      unsigned Amount = R.getZExtValue();
+      if (I.Op == OP_Shr) {
+        Regs[I.Dst] = I.Signed ? L.ashr(Amount) : L.lshr(Amount);
+        break;
+      }
+      // Shifting a negative value, or shifting bits out of a signed value,
+      // is not a core constant expression.
+      if (I.Signed && (L.isNegative() || L.countLeadingZeros() < Amount))
+        return false;
+      Regs[I.Dst] = L.shl(Amount);
+      break;
+    }
+
+    case OP_And:
+      Regs[I.Dst] = Regs[I.A] & Regs[I.B];
+      break;
+    case OP_Or:
+      Regs[I.Dst] = Regs[I.A] | Regs[I.B];
+      break;
+    case OP_Xor:
+      Regs[I.Dst] = Regs[I.A] ^ Regs[I.B];
+      break;
+
+    case OP_EQ:
+      Regs[I.Dst] = APInt(1, Regs[I.A] == Regs[I.B]);
+      break;
+    case OP_NE:
+      Regs[I.Dst] = APInt(1, Regs[I.A] != Regs[I.B]);
+      break;
+    case OP_LT:
+      Regs[I.Dst] = APInt(1, I.Signed ? Regs[I.A].slt(Regs[I.B])
+                                      : Regs[I.A].ult(Regs[I.B]));
+      break;
+    case OP_LE:
+      Regs[I.Dst] = APInt(1, I.Signed ? Regs[I.A].sle(Regs[I.B])
+                                      : Regs[I.A].ule(Regs[I.B]));
+      break;
+    case OP_GT:
+      Regs[I.Dst] = APInt(1, I.Signed ? Regs[I.A].sgt(Regs[I.B])
+                                      : Regs[I.A].ugt(Regs[I.B]));
+      break;
+    case OP_GE:
+      Regs[I.Dst] = APInt(1, I.Signed ? Regs[I.A].sge(Regs[I.B])
+                                      : Regs[I.A].uge(Regs[I.B]));
+      break;
+
+    case OP_Neg:
+      if (I.Signed && Regs[I.A].isMinSignedValue())
+        return false;
+      Regs[I.Dst] = -Regs[I.A];
+      break;
+    case OP_Not:
+      Regs[I.Dst] = ~Regs[I.A];
+      break;
+    case OP_LNot:
+      Regs[I.Dst] = APInt(1, Regs[I.A] == 0);
+      break;
+
+    case OP_Cast: {
+      unsigned Width = F.RegisterWidths[I.Dst];
+      Regs[I.Dst] = I.Signed ? Regs[I.A].sextOrTrunc(Width)
+                             : Regs[I.A].zextOrTrunc(Width);
+      break;
+    }
+
+    case OP_Jump:
+      PC = I.A;
+      break;
+    case OP_JumpIfFalse:
+      if (Regs[I.B] == 0)
+        PC = I.A;
+      break;
+    case OP_JumpIfTrue:
+      if (Regs[I.B] != 0)
+        PC = I.A;
+      break;
+
+    case OP_Call: {
+      if (Depth + 1 > Ctx.getLangOpts().ConstexprCallDepth)
+        return false;
+      const FunctionDecl *Definition = nullptr;
+      const FunctionDecl *Callee = F.Callees[I.A];
+      if (!Callee->getBody(Definition) || !Definition->isConstexpr() ||
+          Definition->isInvalidDecl())
+        return false;
+      const Function *CalleeF = getFunction(Definition);
+      if (!CalleeF)
+        return false;
+
+      // The arguments were evaluated into consecutive registers.
+      unsigned CalleeBase = Stack.size();
+      if (!pushFrame(*CalleeF, makeArrayRef(Stack).slice(FrameBase + I.B,
+                                                         CalleeF->NumParams)))
+        return false;
+      APInt Value;
+      bool Success =
+          execute(*CalleeF, CalleeBase, Depth + 1, StepsLeft, Value);
+      Stack.resize(CalleeBase);
+      if (!Success)
+        return false;
+      Stack[FrameBase + I.Dst] = std::move(Value);
+      break;
+    }
+
+    case OP_Ret:
+      Result = Regs[I.A];
+      return true;
+
+    case OP_Step:
+      if (StepsLeft < I.A)
+        return false;
+      StepsLeft -= I.A;
+      break;
+
+    case OP_Fail:
+      return false;
+    }
+  }
+}
+
+bool ConstexprBytecodeCache::evaluateCall(const FunctionDecl *Definition,
+                                          ArrayRef<APValue> Args,
+                                          unsigned Depth, unsigned &StepsLeft,
+                                          APValue &Result) {
+  const Function *F = getFunction(Definition);
+  if (!F || Args.size() != F->NumParams)
+    return false;
+
+  SmallVector<APInt, 8> ArgValues;
+  for (const APValue &Arg : Args) {
+    if (!Arg.isInt())
+      return false;
+    ArgValues.push_back(Arg.getInt());
+  }
+
+  ++NumEvaluatedCalls;
+  unsigned FrameBase = Stack.size();
+  if (!pushFrame(*F, ArgValues)) {
+    ++NumFailedCalls;
+    return false;
+  }
+
+  // Only commit the steps taken if the evaluation succeeds, as the tree
+  // walker will otherwise redo the whole call.
+  unsigned Steps = StepsLeft;
+  APInt Value;
+  bool Success = execute(*F, FrameBase, Depth, Steps, Value);
+  Stack.resize(FrameBase);
+  if (!Success) {
+    ++NumFailedCalls;
+    return false;
+  }
+
+  StepsLeft = Steps;
+  Result = APValue(llvm::APSInt(std::move(Value), !F->ReturnsSigned));
+  return true;
+}
+
+void ConstexprBytecodeCache::PrintStats() const {
+  unsigned NumCompiled = 0;
+  for (const auto &F : Functions)
+    if (F.second)
+      ++NumCompiled;
+  llvm::errs() << "\n*** Constexpr Bytecode Stats:\n";
+  llvm::errs() << "  " << NumCompiled << "/" << Functions.size()
+               << " constexpr functions compiled to bytecode\n";
+  llvm::errs() << "  " << NumEvaluatedCalls - NumFailedCalls << "/"
+               << NumEvaluatedCalls
+               << " calls evaluated by the bytecode interpreter\n";
+}
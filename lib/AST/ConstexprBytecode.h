@@ -0,0 +1,96 @@
+//===--- ConstexprBytecode.h - Bytecode for constexpr functions -*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This provides a compiler from constexpr function bodies to a compact
+// register bytecode, and an interpreter for that bytecode. It is used by the
+// constant expression evaluator as a fast path for calls to functions that
+// only compute with integers; anything else is left to the tree walker.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_LIB_AST_CONSTEXPRBYTECODE_H
+#define LLVM_CLANG_LIB_AST_CONSTEXPRBYTECODE_H
+
+#include "clang/Basic/LLVM.h"
+#include "llvm/ADT/APSInt.h"
+#include "llvm/ADT/DenseMap.h"
+#include <memory>
+#include <vector>
+
+namespace clang {
+
+class APValue;
+class ASTContext;
+class FunctionDecl;
+
+namespace bytecode {
+struct Function;
+}
+
+/// \brief Caches the bytecode of constexpr functions and evaluates calls to
+/// them.
+///
+/// Only functions whose parameters, locals and return value are all of
+/// integral or enumeration type, and whose bodies only use the statements and
+/// expressions the compiler understands, are compiled. Evaluation fails on
+/// anything that is not a well-defined constant computation (overflow,
+/// division by zero, invalid shifts, falling off the end of the function,
+/// or exceeding the step or depth limits), in which case the caller is
+/// expected to evaluate the call again with the tree walker to produce the
+/// diagnostics.
+class ConstexprBytecodeCache {
+  ASTContext &Ctx;
+
+  /// \brief The compiled functions, keyed by their definition. A null entry
+  /// marks a function that cannot be compiled.
+  llvm::DenseMap<const FunctionDecl *, std::unique_ptr<bytecode::Function>>
+      Functions;
+
+  /// \brief The registers of all active calls, one frame after another. The
+  /// stack always ends with the frame of the innermost active call, so that
+  /// evaluations started while compiling a function (for instance, of case
+  /// labels) can push their frames on top.
+  std::vector<llvm::APInt> Stack;
+
+  /// \brief The number of calls evaluated by the interpreter, and the number
+  /// of those that it handed back to the tree walker.
+  unsigned NumEvaluatedCalls = 0;
+  unsigned NumFailedCalls = 0;
+
+  bool pushFrame(const bytecode::Function &F, ArrayRef<llvm::APInt> Args);
+
+  const bytecode::Function *getFunction(const FunctionDecl *Definition);
+  bool execute(const bytecode::Function &F, unsigned FrameBase,
+               unsigned Depth, unsigned &StepsLeft, llvm::APInt &Result);
+
+public:
+  explicit ConstexprBytecodeCache(ASTContext &Ctx);
+  ~ConstexprBytecodeCache();
+
+  /// \brief Try to evaluate a call to \p Definition.
+  ///
+  /// \param Args The values of the arguments.
+  /// \param Depth The call depth of the callee's frame.
+  /// \param StepsLeft The remaining evaluation steps; only updated if the
+  /// evaluation succeeds.
+  /// \param Result Set to the value returned by the call on success.
+  ///
+  /// \returns true if the call was evaluated, false if it must be evaluated
+  /// by the tree walker instead.
+  bool evaluateCall(const FunctionDecl *Definition, ArrayRef<APValue> Args,
+                    unsigned Depth, unsigned &StepsLeft, APValue &Result);
+
+  /// \brief Print statistics about the compiled functions and evaluated calls
+  /// to llvm::errs().
+  void PrintStats() const;
+};
+
+} // end namespace clang
+
+#endif
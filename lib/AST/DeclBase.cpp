@@ -1137,15 +1137,23 @@ DeclContext::BuildDeclChain(ArrayRef<Decl*> Decls,
   return std::make_pair(FirstNewDecl, PrevDecl);
 }
 
+/// \brief The number of times a lookup table had to be reconciled with new
+/// external visible storage.
+static unsigned NumLookupReconciliations = 0;
+
 /// \brief We have just acquired external visible storage, and we already have
-/// built a lookup map. For every name in the map, pull in the new names from
-/// the external storage.
+/// built a lookup map. Every name in the map needs to pull in the new names
+/// from the external storage the next time it is looked up.
 void DeclContext::reconcileExternalVisibleStorage() const {
   assert(NeedToReconcileExternalVisibleStorage && LookupPtr);
   NeedToReconcileExternalVisibleStorage = false;
+  ++NumLookupReconciliations;
 
-  for (auto &Lookup : *LookupPtr)
-    Lookup.second.setHasExternalDecls();
+  // Rather than flagging each entry, which would make every module that adds
+  // to a large namespace pay for all of its members, forget which names are
+  // known to be up to date.
+  LookupPtr->HasPendingExternalDecls = true;
+  LookupPtr->UpToDateNames.clear();
 }
 
 /// \brief Load the declarations within this lexical storage from an
@@ -1196,6 +1204,7 @@ ExternalASTSource::SetNoExternalVisibleDeclsForName(const DeclContext *DC,
     DC->reconcileExternalVisibleStorage();
 
   (*Map)[Name].removeExternalDecls();
+  Map->setUpToDate(Name);
 
   return DeclContext::lookup_result();
 }
@@ -1212,6 +1221,7 @@ ExternalASTSource::SetExternalVisibleDeclsForName(const DeclContext *DC,
     DC->reconcileExternalVisibleStorage();
 
   StoredDeclsList &List = (*Map)[Name];
+  Map->setUpToDate(Name);
 
   // Clear out any old external visible declarations, to avoid quadratic
   // performance in the redeclaration checks below.
@@ -1483,7 +1493,7 @@ DeclContext::lookup(DeclarationName Name) const {
     // If we have a lookup result with no external decls, we are done.
     std::pair<StoredDeclsMap::iterator, bool> R =
         Map->insert(std::make_pair(Name, StoredDeclsList()));
-    if (!R.second && !R.first->second.hasExternalDecls())
+    if (!R.second && !Map->mayHaveExternalDecls(*R.first))
       return R.first->second.getLookupResult();
 
     if (Source->FindExternalVisibleDeclsByName(this, Name) || !R.second) {
@@ -1766,6 +1776,23 @@ void ASTContext::ReleaseDeclContextMaps() {
   StoredDeclsMap::DestroyAll(LastSDM.getPointer(), LastSDM.getInt());
 }
 
+void StoredDeclsMap::PrintStats(const StoredDeclsMap *Map) {
+  unsigned NumMaps = 0, NumNames = 0, MaxNames = 0;
+  size_t Bytes = 0;
+  for (; Map; Map = Map->Previous.getPointer()) {
+    ++NumMaps;
+    NumNames += Map->size();
+    MaxNames = std::max(MaxNames, Map->size());
+    Bytes += Map->getMemorySize() + Map->UpToDateNames.getMemorySize();
+  }
+
+  llvm::errs() << "  " << NumMaps << " lookup tables, " << NumNames
+               << " names (largest has " << MaxNames << "), " << Bytes
+               << " bytes\n";
+  llvm::errs() << "  " << NumLookupReconciliations
+               << " lookup tables reconciled with new external storage\n";
+}
+
 void StoredDeclsMap::DestroyAll(StoredDeclsMap *Map, bool Dependent) {
   while (Map) {
     // Advance the iteration before we invalidate memory.
@@ -33,6 +33,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "ConstexprBytecode.h"
 #include "clang/AST/APValue.h"
 #include "clang/AST/ASTContext.h"
 #include "clang/AST/ASTDiagnostic.h"
@@ -44,6 +45,7 @@
 #include "clang/AST/TypeLoc.h"
 #include "clang/Basic/Builtins.h"
 #include "clang/Basic/TargetInfo.h"
+#include "clang/Basic/TimeTrace.h"
 #include "llvm/Support/raw_ostream.h"
 #include <cstring>
 #include <functional>
@@ -4123,6 +4125,15 @@ static bool HandleFunctionCall(SourceLocation CallLoc,
   if (!Info.CheckCallLimit(CallLoc))
     return false;
 
+  // Calls that only compute with integers can be evaluated much faster by
+  // the bytecode interpreter. If it gives up, evaluate the call normally to
+  // produce the diagnostics.
+  if (Info.getLangOpts().ConstexprBytecode && !This &&
+      !Info.checkingPotentialConstantExpression() &&
+      Info.Ctx.getConstexprBytecodeCache().evaluateCall(
+          Callee, ArgValues, Info.CallStackDepth + 1, Info.StepsLeft, Result))
+    return true;
+
   CallStackFrame Frame(Info, CallLoc, Callee, This, ArgValues.data());
 
   // For a trivial copy or move assignment, perform an APValue copy. This is
@@ -9797,7 +9808,10 @@ bool Expr::EvaluateAsRValue(EvalResult &Result, const ASTContext &Ctx) const {
   bool IsConst;
   if (FastEvaluateAsRValue(this, Result, Ctx, IsConst))
     return IsConst;
-  
+
+  TimeTraceScope TimeScope("EvaluateAsRValue", [&]() {
+    return getExprLoc().printToString(Ctx.getSourceManager());
+  });
   EvalInfo Info(Ctx, Result, EvalInfo::EM_IgnoreSideEffects);
   return ::EvaluateAsRValue(Info, this, Result.Val);
 }
@@ -9865,6 +9879,10 @@ bool Expr::EvaluateAsInitializer(APValue &Value, const ASTContext &Ctx,
       !Ctx.getLangOpts().CPlusPlus11)
     return false;
 
+  TimeTraceScope TimeScope("EvaluateAsInitializer", [&]() {
+    return VD->getQualifiedNameAsString();
+  });
+
   Expr::EvalStatus EStatus;
   EStatus.Diag = &Notes;
 
@@ -10426,6 +10444,10 @@ bool Expr::isCXX11ConstantExpr(const ASTContext &Ctx, APValue *Result,
   // issues.
   assert(Ctx.getLangOpts().CPlusPlus);
 
+  TimeTraceScope TimeScope("EvaluateAsConstantExpr", [&]() {
+    return getExprLoc().printToString(Ctx.getSourceManager());
+  });
+
   // Build evaluation settings.
   Expr::EvalStatus Status;
   SmallVector<PartialDiagnosticAt, 8> Diags;
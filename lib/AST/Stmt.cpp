@@ -52,7 +52,7 @@ static StmtClassNameTable &getStmtInfoTableEntry(Stmt::StmtClass E) {
 
 void *Stmt::operator new(size_t bytes, const ASTContext& C,
                          unsigned alignment) {
-  return ::operator new(bytes, C, alignment);
+  return C.AllocateStmt(bytes, alignment);
 }
 
 const char *Stmt::getStmtClassName() const {
@@ -0,0 +1,204 @@
+//===--- TimeTrace.cpp - Hierarchical Time Trace Profiler -----------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the time trace profiler and its Chrome trace writer.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Basic/TimeTrace.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+using namespace clang;
+
+LLVM_THREAD_LOCAL TimeTraceProfiler *clang::TimeTraceProfilerInstance = nullptr;
+
+namespace clang {
+
+class TimeTraceProfiler {
+  typedef std::chrono::steady_clock ClockType;
+  typedef std::chrono::time_point<ClockType> TimePointType;
+  typedef std::chrono::microseconds DurationType;
+
+  struct Entry {
+    TimePointType Start;
+    DurationType Duration;
+    std::string Name;
+    std::string Detail;
+    TimeTraceTrack Track;
+  };
+
+  /// \brief The events that are still in progress, per track.
+  SmallVector<Entry, 16> Stacks[TTT_NumTracks];
+
+  /// \brief The events that have finished and were long enough to record.
+  std::vector<Entry> Entries;
+
+  /// \brief The number and total duration of the events with a given name,
+  /// not counting events nested within an event of the same name.
+  llvm::StringMap<std::pair<unsigned, DurationType>> Totals;
+
+  TimePointType StartTime;
+  DurationType Granularity;
+
+public:
+  explicit TimeTraceProfiler(unsigned GranularityMicroseconds)
+      : StartTime(ClockType::now()), Granularity(GranularityMicroseconds) {}
+
+  void begin(StringRef Name, std::string Detail, TimeTraceTrack Track) {
+    Entry E;
+    E.Start = ClockType::now();
+    E.Duration = DurationType(0);
+    E.Name = Name.str();
+    E.Detail = std::move(Detail);
+    E.Track = Track;
+    Stacks[Track].push_back(std::move(E));
+  }
+
+  void end(TimeTraceTrack Track) {
+    auto &Stack = Stacks[Track];
+    if (Stack.empty())
+      return;
+
+    Entry E = Stack.pop_back_val();
+    E.Duration = std::chrono::duration_cast<DurationType>(ClockType::now() -
+                                                          E.Start);
+
+    // Only count the outermost of a set of recursive events (such as nested
+    // template instantiations) towards the total for their name.
+    bool Nested = std::any_of(Stack.begin(), Stack.end(), [&](const Entry &O) {
+      return O.Name == E.Name;
+    });
+    if (!Nested) {
+      auto &Total = Totals[E.Name];
+      ++Total.first;
+      Total.second += E.Duration;
+    }
+
+    if (E.Duration >= Granularity)
+      Entries.push_back(std::move(E));
+  }
+
+  void write(raw_ostream &OS);
+};
+
+} // end namespace clang
+
+/// \brief Write \p Str as a JSON string literal.
+static void writeJSONString(raw_ostream &OS, StringRef Str) {
+  OS << '"';
+  for (unsigned char C : Str) {
+    switch (C) {
+    case '"':  OS << "\\\""; break;
+    case '\\': OS << "\\\\"; break;
+    case '\b': OS << "\\b"; break;
+    case '\f': OS << "\\f"; break;
+    case '\n': OS << "\\n"; break;
+    case '\r': OS << "\\r"; break;
+    case '\t': OS << "\\t"; break;
+    default:
+      if (C < 0x20)
+        OS << llvm::format("\\u%04x", C);
+      else
+        OS << C;
+    }
+  }
+  OS << '"';
+}
+
+static const char *getTrackName(unsigned Track) {
+  switch (Track) {
+  case TTT_Compiler: return "Compiler";
+  case TTT_Source:   return "Source";
+  }
+  return "Other";
+}
+
+void TimeTraceProfiler::write(raw_ostream &OS) {
+  auto timeSinceStart = [&](TimePointType T) {
+    return std::chrono::duration_cast<DurationType>(T - StartTime).count();
+  };
+
+  OS << "{\"traceEvents\":[\n";
+  for (const Entry &E : Entries) {
+    OS << "{\"pid\":1,\"tid\":" << unsigned(E.Track)
+       << ",\"ph\":\"X\",\"ts\":" << timeSinceStart(E.Start)
+       << ",\"dur\":" << E.Duration.count() << ",\"name\":";
+    writeJSONString(OS, E.Name);
+    if (!E.Detail.empty()) {
+      OS << ",\"args\":{\"detail\":";
+      writeJSONString(OS, E.Detail);
+      OS << '}';
+    }
+    OS << "},\n";
+  }
+
+  // Emit the total for each kind of event as a single event on a track of
+  // its own, starting at the beginning of the trace, with the tracks sorted
+  // from most to least expensive.
+  typedef std::pair<StringRef, std::pair<unsigned, DurationType>> NameAndTotal;
+  std::vector<NameAndTotal> SortedTotals;
+  for (const auto &Total : Totals)
+    SortedTotals.push_back(std::make_pair(Total.getKey(), Total.getValue()));
+  std::sort(SortedTotals.begin(), SortedTotals.end(),
+            [](const NameAndTotal &A, const NameAndTotal &B) {
+              if (A.second.second != B.second.second)
+                return A.second.second > B.second.second;
+              return A.first < B.first;
+            });
+  unsigned Tid = TTT_NumTracks;
+  for (const auto &Total : SortedTotals) {
+    unsigned Count = Total.second.first;
+    DurationType Duration = Total.second.second;
+    OS << "{\"pid\":1,\"tid\":" << Tid++ << ",\"ph\":\"X\",\"ts\":0,\"dur\":"
+       << Duration.count() << ",\"name\":";
+    writeJSONString(OS, "Total " + Total.first.str());
+    OS << ",\"args\":{\"count\":" << Count << ",\"avg ms\":"
+       << Duration.count() / Count / 1000 << "}},\n";
+  }
+
+  for (unsigned Track = 0; Track != TTT_NumTracks; ++Track)
+    OS << "{\"pid\":1,\"tid\":" << Track
+       << ",\"ph\":\"M\",\"name\":\"thread_name\",\"args\":{\"name\":\""
+       << getTrackName(Track) << "\"}},\n";
+  OS << "{\"pid\":1,\"tid\":0,\"ph\":\"M\",\"name\":\"process_name\","
+        "\"args\":{\"name\":\"clang\"}}\n";
+  OS << "]}\n";
+}
+
+void clang::timeTraceProfilerInitialize(unsigned GranularityMicroseconds) {
+  assert(!TimeTraceProfilerInstance && "Profiler should not be initialized");
+  TimeTraceProfilerInstance = new TimeTraceProfiler(GranularityMicroseconds);
+}
+
+void clang::timeTraceProfilerCleanup() {
+  delete TimeTraceProfilerInstance;
+  TimeTraceProfilerInstance = nullptr;
+}
+
+void clang::timeTraceProfilerWrite(raw_ostream &OS) {
+  assert(TimeTraceProfilerInstance && "Profiler object can't be null");
+  TimeTraceProfilerInstance->write(OS);
+}
+
+void clang::timeTraceProfilerBegin(StringRef Name, StringRef Detail,
+                                   TimeTraceTrack Track) {
+  if (TimeTraceProfilerInstance)
+    TimeTraceProfilerInstance->begin(Name, Detail.str(), Track);
+}
+
+void clang::timeTraceProfilerEnd(TimeTraceTrack Track) {
+  if (TimeTraceProfilerInstance)
+    TimeTraceProfilerInstance->end(Track);
+}
@@ -11,6 +11,7 @@
 #include "clang/Basic/Diagnostic.h"
 #include "clang/Basic/LangOptions.h"
 #include "clang/Basic/TargetOptions.h"
+#include "clang/Basic/TimeTrace.h"
 #include "clang/Frontend/CodeGenOptions.h"
 #include "clang/Frontend/FrontendDiagnostic.h"
 #include "clang/Frontend/Utils.h"
@@ -27,8 +28,11 @@
 #include "llvm/CodeGen/RegAllocRegistry.h"
 #include "llvm/CodeGen/SchedulerRegistry.h"
 #include "llvm/IR/DataLayout.h"
+#include "llvm/IR/DebugInfoMetadata.h"
+#include "llvm/IR/DiagnosticInfo.h"
 #include "llvm/IR/IRPrintingPasses.h"
 #include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/ModuleSummaryIndex.h"
 #include "llvm/IR/Verifier.h"
@@ -38,9 +42,12 @@
 #include "llvm/Object/ModuleSummaryIndexObjectFile.h"
 #include "llvm/Passes/PassBuilder.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/PrettyStackTrace.h"
+#include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Target/TargetMachine.h"
@@ -54,8 +61,12 @@
 #include "llvm/Transforms/ObjCARC.h"
 #include "llvm/Transforms/Scalar.h"
 #include "llvm/Transforms/Scalar/GVN.h"
+#include "llvm/Transforms/Utils/Cloning.h"
+#include "llvm/Transforms/Utils/SplitModule.h"
 #include "llvm/Transforms/Utils/SymbolRewriter.h"
 #include <memory>
+#include <mutex>
+#include <thread>
 using namespace clang;
 using namespace llvm;
 
@@ -100,7 +111,29 @@ private:
   ///
   /// \return True on success.
   bool AddEmitPasses(legacy::PassManager &CodeGenPasses, BackendAction Action,
-                     raw_pwrite_stream &OS);
+                     raw_pwrite_stream &OS) {
+    return AddEmitPasses(CodeGenPasses, Action, OS, *TM, *TheModule);
+  }
+
+  /// Add passes necessary to emit assembly or an object file for \p M using
+  /// \p Machine.
+  ///
+  /// \return True on success.
+  bool AddEmitPasses(legacy::PassManager &CodeGenPasses, BackendAction Action,
+                     raw_pwrite_stream &OS, TargetMachine &Machine,
+                     const Module &M);
+
+  /// Whether the object file should be generated by splitting the module
+  /// into partitions that are compiled in parallel.
+  bool shouldSplitCodeGen(BackendAction Action) const {
+    return Action == Backend_EmitObj &&
+           !CodeGenOpts.SplitCodeGenOutputs.empty();
+  }
+
+  /// Split the module into partitions and generate an object file for each of
+  /// them in parallel. The first partition is written to \p OS, the others
+  /// to the files named by -split-codegen-output.
+  void EmitSplitObjects(raw_pwrite_stream &OS);
 
 public:
   EmitAssemblyHelper(DiagnosticsEngine &_Diags,
@@ -621,9 +654,11 @@ void EmitAssemblyHelper::CreateTargetMachine(bool MustCreateTM) {
 
 bool EmitAssemblyHelper::AddEmitPasses(legacy::PassManager &CodeGenPasses,
                                        BackendAction Action,
-                                       raw_pwrite_stream &OS) {
+                                       raw_pwrite_stream &OS,
+                                       TargetMachine &Machine,
+                                       const Module &M) {
   // Add LibraryInfo.
-  llvm::Triple TargetTriple(TheModule->getTargetTriple());
+  llvm::Triple TargetTriple(M.getTargetTriple());
   std::unique_ptr<TargetLibraryInfoImpl> TLII(
       createTLII(TargetTriple, CodeGenOpts));
   CodeGenPasses.add(new TargetLibraryInfoWrapperPass(*TLII));
@@ -644,8 +679,8 @@ bool EmitAssemblyHelper::AddEmitPasses(legacy::PassManager &CodeGenPasses,
   if (CodeGenOpts.OptimizationLevel > 0)
     CodeGenPasses.add(createObjCARCContractPass());
 
-  if (TM->addPassesToEmitFile(CodeGenPasses, OS, CGFT,
-                              /*DisableVerify=*/!CodeGenOpts.VerifyModule)) {
+  if (Machine.addPassesToEmitFile(CodeGenPasses, OS, CGFT,
+                                 /*DisableVerify=*/!CodeGenOpts.VerifyModule)) {
     Diags.Report(diag::err_fe_unable_to_interface_with_target);
     return false;
   }
@@ -653,6 +688,251 @@ bool EmitAssemblyHelper::AddEmitPasses(legacy::PassManager &CodeGenPasses,
   return true;
 }
 
+/// Give a name to the unnamed globals that are visible outside of the module,
+/// so that the partitions that use them can refer to them.
+static void nameUnnamedGlobals(Module &M) {
+  unsigned Counter = 0;
+  auto NameGlobal = [&](GlobalValue &GV) {
+    if (!GV.hasName() && !GV.hasLocalLinkage())
+      GV.setName("__split_codegen_anon." + Twine(Counter++));
+  };
+  for (Function &F : M)
+    NameGlobal(F);
+  for (GlobalVariable &GV : M.globals())
+    NameGlobal(GV);
+  for (GlobalAlias &GA : M.aliases())
+    NameGlobal(GA);
+  for (GlobalIFunc &GI : M.ifuncs())
+    NameGlobal(GI);
+}
+
+namespace {
+/// For each compile unit of a module, the position in the module's list of
+/// globals of the variable that each of the unit's global variable
+/// expressions describes, or NoDebugGlobalOwner if it describes no variable
+/// defined in the module.
+typedef std::vector<std::vector<unsigned>> DebugGlobalOwners;
+const unsigned NoDebugGlobalOwner = ~0U;
+} // end anonymous namespace
+
+static DebugGlobalOwners findDebugGlobalOwners(const Module &M) {
+  DenseMap<const DIGlobalVariableExpression *, unsigned> Owner;
+  unsigned Index = 0;
+  for (const GlobalVariable &GV : M.globals()) {
+    SmallVector<DIGlobalVariableExpression *, 1> GVEs;
+    if (!GV.isDeclaration())
+      GV.getDebugInfo(GVEs);
+    for (const DIGlobalVariableExpression *GVE : GVEs)
+      Owner[GVE] = Index;
+    ++Index;
+  }
+
+  DebugGlobalOwners Owners;
+  for (const DICompileUnit *CU : M.debug_compile_units()) {
+    Owners.emplace_back();
+    for (const DIGlobalVariableExpression *GVE : CU->getGlobalVariables()) {
+      auto It = Owner.find(GVE);
+      Owners.back().push_back(It == Owner.end() ? NoDebugGlobalOwner
+                                                : It->second);
+    }
+  }
+  return Owners;
+}
+
+/// SplitModule copies the compile units into every partition. Describe a
+/// global variable only in the partition that defines it, so that it does
+/// not show up without a location in the others, and leave the remaining
+/// global variables, enumerations, retained types, imported entities and
+/// macros to the first partition.
+///
+/// \param Part The index of partition \p M.
+/// \param Owners The owners of the global variable expressions of the module
+/// that was split, as returned by findDebugGlobalOwners.
+/// \param SplitDwarfFile If not empty, the split DWARF file of the partition.
+static void prunePartitionDebugInfo(Module &M, unsigned Part,
+                                    const DebugGlobalOwners &Owners,
+                                    StringRef SplitDwarfFile) {
+  // The partitions have the same globals, in the same order, as the module.
+  SmallVector<const GlobalVariable *, 64> Globals;
+  for (const GlobalVariable &GV : M.globals())
+    Globals.push_back(&GV);
+
+  unsigned CUIndex = 0;
+  for (DICompileUnit *CU : M.debug_compile_units()) {
+    const std::vector<unsigned> &CUOwners = Owners[CUIndex++];
+    SmallVector<Metadata *, 16> GVEs;
+    unsigned Index = 0;
+    for (DIGlobalVariableExpression *GVE : CU->getGlobalVariables()) {
+      unsigned Owner = CUOwners[Index++];
+      if (Owner == NoDebugGlobalOwner ? Part == 0
+                                      : !Globals[Owner]->isDeclaration())
+        GVEs.push_back(GVE);
+    }
+    CU->replaceGlobalVariables(MDTuple::get(M.getContext(), GVEs));
+
+    if (Part != 0) {
+      CU->replaceEnumTypes(nullptr);
+      CU->replaceRetainedTypes(nullptr);
+      CU->replaceImportedEntities(nullptr);
+      CU->replaceMacros(nullptr);
+    }
+
+    // The name of the split DWARF file is the fourth operand of the compile
+    // unit, which has no setter for it.
+    if (!SplitDwarfFile.empty())
+      CU->replaceOperandWith(3, MDString::get(M.getContext(), SplitDwarfFile));
+  }
+}
+
+namespace {
+/// A partition of the module together with everything needed to generate
+/// code for it on a thread of its own.
+struct CodeGenPartition {
+  LLVMContext Context;
+  std::unique_ptr<Module> M;
+  std::unique_ptr<TargetMachine> TM;
+  std::string Path;
+  std::unique_ptr<raw_fd_ostream> File;
+  legacy::PassManager Passes;
+};
+
+/// Forwards the backend diagnostics of the partitions to the handlers of the
+/// module's context, one at a time, so that they are reported exactly like
+/// those of a module that is not split.
+class PartitionDiagnosticForwarder {
+  LLVMContext &ModuleContext;
+  std::mutex Lock;
+
+  static void handleDiagnostic(const DiagnosticInfo &DI, void *Context) {
+    auto *Forwarder = static_cast<PartitionDiagnosticForwarder *>(Context);
+    std::lock_guard<std::mutex> Guard(Forwarder->Lock);
+    Forwarder->ModuleContext.diagnose(DI);
+  }
+
+  static void handleInlineAsmDiagnostic(const SMDiagnostic &D, void *Context,
+                                        unsigned LocCookie) {
+    auto *Forwarder = static_cast<PartitionDiagnosticForwarder *>(Context);
+    std::lock_guard<std::mutex> Guard(Forwarder->Lock);
+    LLVMContext &Ctx = Forwarder->ModuleContext;
+    Ctx.getInlineAsmDiagnosticHandler()(D, Ctx.getInlineAsmDiagnosticContext(),
+                                        LocCookie);
+  }
+
+public:
+  explicit PartitionDiagnosticForwarder(LLVMContext &ModuleContext)
+      : ModuleContext(ModuleContext) {}
+
+  /// Forward the diagnostics reported in the context of a partition.
+  void forward(LLVMContext &PartitionContext) {
+    PartitionContext.setDiagnosticHandler(handleDiagnostic, this);
+    PartitionContext.setDiagnosticHotnessRequested(
+        ModuleContext.getDiagnosticHotnessRequested());
+    if (ModuleContext.getInlineAsmDiagnosticHandler())
+      PartitionContext.setInlineAsmDiagnosticHandler(
+          handleInlineAsmDiagnostic, this);
+  }
+};
+} // end anonymous namespace
+
+void EmitAssemblyHelper::EmitSplitObjects(raw_pwrite_stream &OS) {
+  unsigned NumParts = CodeGenOpts.SplitCodeGenOutputs.size() + 1;
+
+  // SplitModule takes the module apart, so split a copy of it. Local
+  // definitions are kept local, in the partition of their users; all other
+  // globals need a name so that the partitions can refer to each other.
+  std::unique_ptr<Module> Copy = CloneModule(TheModule);
+  nameUnnamedGlobals(*Copy);
+  DebugGlobalOwners Owners = findDebugGlobalOwners(*Copy);
+
+  // Each partition gets a context of its own, so that the threads do not
+  // share any IR. SplitModule clones within a context, so move each
+  // partition into its context through bitcode, as splitCodeGen does. That
+  // function cannot be used directly since it does not let the partitions
+  // report their diagnostics to the module's context.
+  PartitionDiagnosticForwarder Forwarder(TheModule->getContext());
+  std::vector<std::unique_ptr<CodeGenPartition>> Parts;
+  bool Failed = false;
+  SplitModule(std::move(Copy), NumParts, [&](std::unique_ptr<Module> MPart) {
+    if (Failed)
+      return;
+    unsigned I = Parts.size();
+
+    SmallString<0> Bitcode;
+    {
+      raw_svector_ostream BitcodeOS(Bitcode);
+      WriteBitcodeToFile(MPart.get(), BitcodeOS);
+    }
+    MPart.reset();
+
+    auto Part = llvm::make_unique<CodeGenPartition>();
+    Forwarder.forward(Part->Context);
+    Expected<std::unique_ptr<Module>> MOrErr = parseBitcodeFile(
+        MemoryBufferRef(Bitcode.str(), TheModule->getModuleIdentifier()),
+        Part->Context);
+    if (!MOrErr)
+      report_fatal_error("failed to split module for code generation: " +
+                         toString(MOrErr.takeError()));
+    Part->M = std::move(*MOrErr);
+
+    StringRef SplitDwarfFile;
+    if (I != 0 && I - 1 < CodeGenOpts.SplitCodeGenDwarfFiles.size())
+      SplitDwarfFile = CodeGenOpts.SplitCodeGenDwarfFiles[I - 1];
+    prunePartitionDebugInfo(*Part->M, I, Owners, SplitDwarfFile);
+
+    Part->TM.reset(TM->getTarget().createTargetMachine(
+        TM->getTargetTriple().str(), TM->getTargetCPU(),
+        TM->getTargetFeatureString(), TM->Options, TM->getRelocationModel(),
+        TM->getCodeModel(), TM->getOptLevel()));
+
+    raw_pwrite_stream *PartOS = &OS;
+    if (I != 0) {
+      std::error_code EC;
+      Part->Path = CodeGenOpts.SplitCodeGenOutputs[I - 1];
+      Part->File.reset(new raw_fd_ostream(Part->Path, EC, sys::fs::F_None));
+      if (EC) {
+        Diags.Report(diag::err_fe_unable_to_open_output)
+            << Part->Path << EC.message();
+        Failed = true;
+        return;
+      }
+      PartOS = Part->File.get();
+    }
+
+    Part->Passes.add(
+        createTargetTransformInfoWrapperPass(Part->TM->getTargetIRAnalysis()));
+    if (!AddEmitPasses(Part->Passes, Backend_EmitObj, *PartOS, *Part->TM,
+                       *Part->M)) {
+      Failed = true;
+      return;
+    }
+    Parts.push_back(std::move(Part));
+  }, /*PreserveLocals=*/true);
+  if (Failed)
+    return;
+
+  {
+    // Do not start more threads than the host can run at once.
+    unsigned NumThreads = std::max(1u, std::thread::hardware_concurrency());
+    ThreadPool Pool(std::min(NumParts, NumThreads));
+    for (auto &Part : Parts) {
+      CodeGenPartition *P = Part.get();
+      Pool.async([P] { P->Passes.run(*P->M); });
+    }
+    Pool.wait();
+  }
+
+  for (auto &Part : Parts) {
+    if (Part->File) {
+      Part->File->close();
+      if (Part->File->has_error()) {
+        Diags.Report(diag::err_fe_unable_to_open_output)
+            << Part->Path << Part->File->error().message();
+        Part->File->clear_error();
+      }
+    }
+  }
+}
+
 void EmitAssemblyHelper::EmitAssembly(BackendAction Action,
                                       std::unique_ptr<raw_pwrite_stream> OS) {
   TimeRegion Region(llvm::TimePassesIsEnabled ? &CodeGenerationTime : nullptr);
@@ -699,7 +979,8 @@ void EmitAssemblyHelper::EmitAssembly(BackendAction Action,
     break;
 
   default:
-    if (!AddEmitPasses(CodeGenPasses, Action, *OS))
+    if (!shouldSplitCodeGen(Action) &&
+        !AddEmitPasses(CodeGenPasses, Action, *OS))
       return;
   }
 
@@ -711,22 +992,31 @@ void EmitAssemblyHelper::EmitAssembly(BackendAction Action,
 
   {
     PrettyStackTraceString CrashInfo("Per-function optimization");
+    TimeTraceScope TimeScope("PerFunctionPasses");
 
     PerFunctionPasses.doInitialization();
     for (Function &F : *TheModule)
-      if (!F.isDeclaration())
+      if (!F.isDeclaration()) {
+        TimeTraceScope FunctionScope("OptFunction",
+                                     [&]() { return F.getName().str(); });
         PerFunctionPasses.run(F);
+      }
     PerFunctionPasses.doFinalization();
   }
 
   {
     PrettyStackTraceString CrashInfo("Per-module optimization passes");
+    TimeTraceScope TimeScope("PerModulePasses");
     PerModulePasses.run(*TheModule);
   }
 
   {
     PrettyStackTraceString CrashInfo("Code generation");
-    CodeGenPasses.run(*TheModule);
+    TimeTraceScope TimeScope("CodeGenPasses");
+    if (shouldSplitCodeGen(Action))
+      EmitSplitObjects(*OS);
+    else
+      CodeGenPasses.run(*TheModule);
   }
 }
 
@@ -837,6 +1127,8 @@ void EmitAssemblyHelper::EmitAssemblyWithNewPassManager(
   case Backend_EmitMCNull:
   case Backend_EmitObj:
     NeedCodeGen = true;
+    if (shouldSplitCodeGen(Action))
+      break;
     CodeGenPasses.add(
         createTargetTransformInfoWrapperPass(getTargetIRAnalysis()));
     if (!AddEmitPasses(CodeGenPasses, Action, *OS))
@@ -851,13 +1143,19 @@ void EmitAssemblyHelper::EmitAssemblyWithNewPassManager(
   // Now that we have all of the passes ready, run them.
   {
     PrettyStackTraceString CrashInfo("Optimizer");
+    TimeTraceScope TimeScope("Optimizer");
     MPM.run(*TheModule, MAM);
   }
 
   // Now if needed, run the legacy PM for codegen.
   if (NeedCodeGen) {
     PrettyStackTraceString CrashInfo("Code generation");
+    TimeTraceScope TimeScope("CodeGenPasses");
     CodeGenPasses.run(*TheModule);
+  } else if (shouldSplitCodeGen(Action)) {
+    PrettyStackTraceString CrashInfo("Code generation");
+    TimeTraceScope TimeScope("CodeGenPasses");
+    EmitSplitObjects(*OS);
   }
 }
 
@@ -947,6 +1245,8 @@ void clang::EmitBackendOutput(DiagnosticsEngine &Diags,
                               const llvm::DataLayout &TDesc, Module *M,
                               BackendAction Action,
                               std::unique_ptr<raw_pwrite_stream> OS) {
+  TimeTraceScope TimeScope("Backend");
+
   if (!CGOpts.ThinLTOIndexFile.empty()) {
     // If we are performing a ThinLTO importing compile, load the function index
     // into memory and pass it into runThinLTOBackend, which will run the
@@ -23,6 +23,7 @@
 #include "clang/AST/Decl.h"
 #include "clang/AST/DeclCXX.h"
 #include "clang/AST/DeclObjC.h"
+#include "clang/AST/RecordLayout.h"
 #include "clang/Basic/TargetBuiltins.h"
 #include "clang/Basic/TargetInfo.h"
 #include "clang/CodeGen/CGFunctionInfo.h"
@@ -1620,9 +1621,68 @@ static void AddAttributesFromFunctionProtoType(ASTContext &Ctx,
     FuncAttrs.addAttribute(llvm::Attribute::NoUnwind);
 }
 
+/// Returns the attribute (either parameter attribute, or function
+/// attribute), which declares argument ArgNo to be non-null.
+static const NonNullAttr *getNonNullAttr(const Decl *FD, const ParmVarDecl *PVD,
+                                         QualType ArgType, unsigned ArgNo) {
+  // FIXME: __attribute__((nonnull)) can also be applied to:
+  //   - references to pointers, where the pointee is known to be
+  //     nonnull (apparently a Clang extension)
+  //   - transparent unions containing pointers
+  // In the former case, LLVM IR cannot represent the constraint. In
+  // the latter case, we have no guarantee that the transparent union
+  // is in fact passed as a pointer.
+  if (!ArgType->isAnyPointerType() && !ArgType->isBlockPointerType())
+    return nullptr;
+  // First, check attribute on parameter itself.
+  if (PVD) {
+    if (auto ParmNNAttr = PVD->getAttr<NonNullAttr>())
+      return ParmNNAttr;
+  }
+  // Check function attributes.
+  if (!FD)
+    return nullptr;
+  for (const auto *NNAttr : FD->specific_attrs<NonNullAttr>()) {
+    if (NNAttr->isNonNull(ArgNo))
+      return NNAttr;
+  }
+  return nullptr;
+}
+
+/// Returns the number of bytes that can be accessed through a pointer to a
+/// valid object of type \p T. A pointer to a class that isn't final may point
+/// to a base class subobject, which only has the non-virtual size.
+static CharUnits getMinimumObjectSize(ASTContext &Ctx, QualType T) {
+  if (const CXXRecordDecl *RD = T->getAsCXXRecordDecl())
+    if (!RD->hasAttr<FinalAttr>())
+      return std::max(Ctx.getASTRecordLayout(RD).getNonVirtualSize(),
+                      CharUnits::One());
+  return Ctx.getTypeSizeInChars(T);
+}
+
+/// Add the attributes of a pointer that must point to a valid object of type
+/// \p PTy, such as a reference or 'this': nonnull, dereferenceable and align.
+static void addValidObjectPointerAttrs(CodeGenModule &CGM,
+                                       llvm::AttrBuilder &Attrs,
+                                       QualType PTy) {
+  ASTContext &Ctx = CGM.getContext();
+  if (Ctx.getTargetAddressSpace(PTy) == 0)
+    Attrs.addAttribute(llvm::Attribute::NonNull);
+  if (PTy->isIncompleteType() || !PTy->isConstantSizeType() ||
+      !PTy->isObjectType())
+    return;
+  if (!Attrs.getDereferenceableBytes())
+    Attrs.addDereferenceableAttr(getMinimumObjectSize(Ctx, PTy).getQuantity());
+  CharUnits Align = CGM.getNaturalTypeAlignment(PTy, /*Source=*/nullptr,
+                                                /*forPointeeType=*/true);
+  if (Align > CharUnits::One())
+    Attrs.addAlignmentAttr(Align.getQuantity());
+}
+
 void CodeGenModule::ConstructAttributeList(
     StringRef Name, const CGFunctionInfo &FI, CGCalleeInfo CalleeInfo,
-    AttributeListType &PAL, unsigned &CallingConv, bool AttrOnCallSite) {
+    AttributeListType &PAL, unsigned &CallingConv, bool AttrOnCallSite,
+    bool IsThunk) {
   llvm::AttrBuilder FuncAttrs;
   llvm::AttrBuilder RetAttrs;
   bool HasOptnone = false;
@@ -1874,6 +1934,8 @@ void CodeGenModule::ConstructAttributeList(
                                         .getQuantity());
     else if (getContext().getTargetAddressSpace(PTy) == 0)
       RetAttrs.addAttribute(llvm::Attribute::NonNull);
+    if (CodeGenOpts.StrictPointerAttributes)
+      addValidObjectPointerAttrs(*this, RetAttrs, PTy);
   }
 
   // Attach return attributes.
@@ -1903,6 +1965,16 @@ void CodeGenModule::ConstructAttributeList(
         getLLVMContext(), IRFunctionArgs.getInallocaArgNo() + 1, Attrs));
   }
 
+  // Map the arguments to the parameters of the callee, to find the ones that
+  // are declared nonnull. Implicit arguments other than 'this', such as VTTs,
+  // make the mapping ambiguous.
+  const FunctionDecl *ParamFD = nullptr;
+  unsigned FirstParamArgNo = FI.isInstanceMethod() ? 1 : 0;
+  if (CodeGenOpts.StrictPointerAttributes)
+    if (const auto *FD = dyn_cast_or_null<FunctionDecl>(TargetDecl))
+      if (FI.getNumRequiredArgs() == FD->getNumParams() + FirstParamArgNo)
+        ParamFD = FD;
+
   unsigned ArgNo = 0;
   for (CGFunctionInfo::const_arg_iterator I = FI.arg_begin(),
                                           E = FI.arg_end();
@@ -1990,6 +2062,25 @@ void CodeGenModule::ConstructAttributeList(
                                        .getQuantity());
       else if (getContext().getTargetAddressSpace(PTy) == 0)
         Attrs.addAttribute(llvm::Attribute::NonNull);
+      if (CodeGenOpts.StrictPointerAttributes)
+        addValidObjectPointerAttrs(*this, Attrs, PTy);
+    }
+
+    if (CodeGenOpts.StrictPointerAttributes && AI.isDirect()) {
+      // Calling a member function through a null or misaligned pointer is
+      // undefined, so 'this' always points to a valid object. A thunk gets
+      // 'this' before it is adjusted, pointing into the middle of the object.
+      if (ArgNo == 0 && FI.isInstanceMethod()) {
+        if (const auto *PT = ParamType->getAs<PointerType>())
+          if (!IsThunk)
+            addValidObjectPointerAttrs(*this, Attrs, PT->getPointeeType());
+      } else if (ParamFD && ArgNo >= FirstParamArgNo &&
+                 ArgNo - FirstParamArgNo < ParamFD->getNumParams()) {
+        unsigned ParamNo = ArgNo - FirstParamArgNo;
+        const ParmVarDecl *PVD = ParamFD->getParamDecl(ParamNo);
+        if (getNonNullAttr(ParamFD, PVD, PVD->getType(), ParamNo))
+          Attrs.addAttribute(llvm::Attribute::NonNull);
+      }
     }
 
     switch (FI.getExtParameterInfo(ArgNo).getABI()) {
@@ -2064,34 +2155,6 @@ static llvm::Value *emitArgumentDemotion(CodeGenFunction &CGF,
   return CGF.Builder.CreateFPCast(value, varType, "arg.unpromote");
 }
 
-/// Returns the attribute (either parameter attribute, or function
-/// attribute), which declares argument ArgNo to be non-null.
-static const NonNullAttr *getNonNullAttr(const Decl *FD, const ParmVarDecl *PVD,
-                                         QualType ArgType, unsigned ArgNo) {
-  // FIXME: __attribute__((nonnull)) can also be applied to:
-  //   - references to pointers, where the pointee is known to be
-  //     nonnull (apparently a Clang extension)
-  //   - transparent unions containing pointers
-  // In the former case, LLVM IR cannot represent the constraint. In
-  // the latter case, we have no guarantee that the transparent union
-  // is in fact passed as a pointer.
-  if (!ArgType->isAnyPointerType() && !ArgType->isBlockPointerType())
-    return nullptr;
-  // First, check attribute on parameter itself.
-  if (PVD) {
-    if (auto ParmNNAttr = PVD->getAttr<NonNullAttr>())
-      return ParmNNAttr;
-  }
-  // Check function attributes.
-  if (!FD)
-    return nullptr;
-  for (const auto *NNAttr : FD->specific_attrs<NonNullAttr>()) {
-    if (NNAttr->isNonNull(ArgNo))
-      return NNAttr;
-  }
-  return nullptr;
-}
-
 namespace {
   struct CopyBackSwiftError final : EHScopeStack::Cleanup {
     Address Temp;
@@ -3976,7 +4039,7 @@ RValue CodeGenFunction::EmitCall(const CGFunctionInfo &CallInfo,
   CGM.ConstructAttributeList(CalleePtr->getName(), CallInfo,
                              Callee.getAbstractInfo(),
                              AttributeList, CallingConv,
-                             /*AttrOnCallSite=*/true);
+                             /*AttrOnCallSite=*/true, /*IsThunk=*/false);
   llvm::AttributeSet Attrs = llvm::AttributeSet::get(getLLVMContext(),
                                                      AttributeList);
 
@@ -804,6 +804,9 @@ void CodeGenFunction::EmitConstructorBody(FunctionArgList &Args) {
           CtorType == Ctor_Complete) &&
          "can only generate complete ctor for this ABI");
 
+  if (CGDebugInfo *DI = getDebugInfo())
+    DI->completeClassForConstructor(Ctor);
+
   // Before we go any further, try the complete->base constructor
   // delegation optimization.
   if (CtorType == Ctor_Complete && IsConstructorDelegationValid(Ctor) &&
@@ -62,6 +62,7 @@ static uint32_t getDeclAlignIfRequired(const Decl *D, const ASTContext &Ctx) {
 CGDebugInfo::CGDebugInfo(CodeGenModule &CGM)
     : CGM(CGM), DebugKind(CGM.getCodeGenOpts().getDebugInfo()),
       DebugTypeExtRefs(CGM.getCodeGenOpts().DebugTypeExtRefs),
+      DebugCtorHoming(CGM.getCodeGenOpts().DebugCtorHoming),
       DBuilder(CGM.getModule()) {
   for (const auto &KV : CGM.getCodeGenOpts().DebugPrefixMap)
     DebugPrefixMap[KV.first] = KV.second;
@@ -270,13 +271,18 @@ StringRef CGDebugInfo::getSelectorName(Selector S) {
 
 StringRef CGDebugInfo::getClassName(const RecordDecl *RD) {
   if (isa<ClassTemplateSpecializationDecl>(RD)) {
+    StringRef &CachedName = SpecializationNames[RD];
+    if (!CachedName.empty())
+      return CachedName;
+
     SmallString<128> Name;
     llvm::raw_svector_ostream OS(Name);
     RD->getNameForDiagnostic(OS, CGM.getContext().getPrintingPolicy(),
                              /*Qualified*/ false);
 
     // Copy this name on the side and use its reference.
-    return internString(Name);
+    CachedName = internString(Name);
+    return CachedName;
   }
 
   // quick optimization to avoid having to intern strings that are already
@@ -730,20 +736,24 @@ static bool hasCXXMangling(const TagDecl *TD, llvm::DICompileUnit *TheCU) {
 
 /// In C++ mode, types have linkage, so we can rely on the ODR and
 /// on their mangled names, if they're external.
-static SmallString<256> getUniqueTagTypeName(const TagType *Ty,
-                                             CodeGenModule &CGM,
-                                             llvm::DICompileUnit *TheCU) {
-  SmallString<256> FullName;
+StringRef CGDebugInfo::getUniqueTagTypeName(const TagType *Ty) {
   const TagDecl *TD = Ty->getDecl();
-
   if (!hasCXXMangling(TD, TheCU) || !TD->isExternallyVisible())
-    return FullName;
+    return StringRef();
+
+  // A type is usually described twice, by a declaration and by its
+  // definition, and mangling large template instantiations is expensive.
+  StringRef &Name = UniqueTagTypeNames[TD->getCanonicalDecl()];
+  if (!Name.empty())
+    return Name;
 
   // TODO: This is using the RTTI name. Is there a better way to get
   // a unique string for a type?
+  SmallString<256> FullName;
   llvm::raw_svector_ostream Out(FullName);
   CGM.getCXXABI().getMangleContext().mangleCXXRTTIName(QualType(Ty, 0), Out);
-  return FullName;
+  Name = internString(FullName);
+  return Name;
 }
 
 /// \return the approproate DWARF tag for a composite type.
@@ -776,7 +786,7 @@ CGDebugInfo::getOrCreateRecordFwdDecl(const RecordType *Ty,
   uint32_t Align = 0;
 
   // Create the type.
-  SmallString<256> FullName = getUniqueTagTypeName(Ty, CGM, TheCU);
+  StringRef FullName = getUniqueTagTypeName(Ty);
   llvm::DICompositeType *RetTy = DBuilder.createReplaceableCompositeType(
       getTagForRecord(RD), RDName, Ctx, DefUnit, Line, 0, Size, Align,
       llvm::DINode::FlagFwdDecl, FullName);
@@ -1770,8 +1780,32 @@ static bool isClassOrMethodDLLImport(const CXXRecordDecl *RD) {
   return false;
 }
 
+/// Return true if no object of the class can be created without emitting the
+/// code of one of its constructors, so that the class definition can be
+/// emitted along with the constructors.
+static bool canUseCtorHoming(const CXXRecordDecl *RD) {
+  // Dynamic classes are already emitted along with their vtable.
+  if (RD->isDynamicClass())
+    return false;
+
+  // Aggregates, and classes with trivial or constexpr constructors, can be
+  // created without emitting any code for a constructor.
+  if (RD->isLambda() || RD->isAggregate() ||
+      RD->hasTrivialDefaultConstructor() ||
+      RD->hasConstexprNonCopyMoveConstructor())
+    return false;
+
+  // Copies and moves need an existing object, so a usable constructor other
+  // than those must exist.
+  for (const CXXConstructorDecl *Ctor : RD->ctors())
+    if (!Ctor->isCopyOrMoveConstructor() && !Ctor->isDeleted())
+      return true;
+  return false;
+}
+
 static bool shouldOmitDefinition(codegenoptions::DebugInfoKind DebugKind,
-                                 bool DebugTypeExtRefs, const RecordDecl *RD,
+                                 bool DebugTypeExtRefs, bool DebugCtorHoming,
+                                 const RecordDecl *RD,
                                  const LangOptions &LangOpts) {
   if (DebugTypeExtRefs && isDefinedInClangModule(RD->getDefinition()))
     return true;
@@ -1800,6 +1834,14 @@ static bool shouldOmitDefinition(codegenoptions::DebugInfoKind DebugKind,
       !isClassOrMethodDLLImport(CXXDecl))
     return true;
 
+  // Similarly, with constructor homing, only emit complete debug info for a
+  // class that cannot be created without a constructor call when one of its
+  // constructors is emitted.
+  if (DebugCtorHoming && CXXDecl->hasDefinition() &&
+      canUseCtorHoming(CXXDecl->getDefinition()) &&
+      !isClassOrMethodDLLImport(CXXDecl))
+    return true;
+
   TemplateSpecializationKind Spec = TSK_Undeclared;
   if (const auto *SD = dyn_cast<ClassTemplateSpecializationDecl>(RD))
     Spec = SD->getSpecializationKind();
@@ -1813,7 +1855,8 @@ static bool shouldOmitDefinition(codegenoptions::DebugInfoKind DebugKind,
 }
 
 void CGDebugInfo::completeRequiredType(const RecordDecl *RD) {
-  if (shouldOmitDefinition(DebugKind, DebugTypeExtRefs, RD, CGM.getLangOpts()))
+  if (shouldOmitDefinition(DebugKind, DebugTypeExtRefs, DebugCtorHoming, RD,
+                           CGM.getLangOpts()))
     return;
 
   QualType Ty = CGM.getContext().getRecordType(RD);
@@ -1822,11 +1865,19 @@ void CGDebugInfo::completeRequiredType(const RecordDecl *RD) {
     completeClassData(RD);
 }
 
+void CGDebugInfo::completeClassForConstructor(const CXXConstructorDecl *CD) {
+  if (!DebugCtorHoming || DebugKind != codegenoptions::LimitedDebugInfo)
+    return;
+  const CXXRecordDecl *RD = CD->getParent();
+  if (canUseCtorHoming(RD) && !isClassOrMethodDLLImport(RD))
+    completeClassData(RD);
+}
+
 llvm::DIType *CGDebugInfo::CreateType(const RecordType *Ty) {
   RecordDecl *RD = Ty->getDecl();
   llvm::DIType *T = cast_or_null<llvm::DIType>(getTypeOrNull(QualType(Ty, 0)));
-  if (T || shouldOmitDefinition(DebugKind, DebugTypeExtRefs, RD,
-                                CGM.getLangOpts())) {
+  if (T || shouldOmitDefinition(DebugKind, DebugTypeExtRefs, DebugCtorHoming,
+                                RD, CGM.getLangOpts())) {
     if (!T)
       T = getOrCreateRecordFwdDecl(Ty, getDeclContextDescriptor(RD));
     return T;
@@ -2342,7 +2393,7 @@ llvm::DIType *CGDebugInfo::CreateEnumType(const EnumType *Ty) {
     Align = getDeclAlignIfRequired(ED, CGM.getContext());
   }
 
-  SmallString<256> FullName = getUniqueTagTypeName(Ty, CGM, TheCU);
+  StringRef FullName = getUniqueTagTypeName(Ty);
 
   bool isImportedFromModule =
       DebugTypeExtRefs && ED->isFromASTFile() && ED->getDefinition();
@@ -2385,7 +2436,7 @@ llvm::DIType *CGDebugInfo::CreateTypeDefinition(const EnumType *Ty) {
     Align = getDeclAlignIfRequired(ED, CGM.getContext());
   }
 
-  SmallString<256> FullName = getUniqueTagTypeName(Ty, CGM, TheCU);
+  StringRef FullName = getUniqueTagTypeName(Ty);
 
   // Create elements for each enumerator.
   SmallVector<llvm::Metadata *, 16> Enumerators;
@@ -2684,7 +2735,7 @@ llvm::DICompositeType *CGDebugInfo::CreateLimitedType(const RecordType *Ty) {
   uint64_t Size = CGM.getContext().getTypeSize(Ty);
   auto Align = getDeclAlignIfRequired(D, CGM.getContext());
 
-  SmallString<256> FullName = getUniqueTagTypeName(Ty, CGM, TheCU);
+  StringRef FullName = getUniqueTagTypeName(Ty);
 
   llvm::DICompositeType *RealDecl = DBuilder.createReplaceableCompositeType(
       getTagForRecord(RD), RDName, RDContext, DefUnit, Line, 0, Size, Align,
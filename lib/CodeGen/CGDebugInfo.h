@@ -56,6 +56,7 @@ class CGDebugInfo {
   CodeGenModule &CGM;
   const codegenoptions::DebugInfoKind DebugKind;
   bool DebugTypeExtRefs;
+  bool DebugCtorHoming;
   llvm::DIBuilder DBuilder;
   llvm::DICompileUnit *TheCU = nullptr;
   ModuleMap *ClangModuleMap = nullptr;
@@ -130,6 +131,13 @@ class CGDebugInfo {
   llvm::DenseMap<const Decl *, llvm::TypedTrackingMDRef<llvm::DIDerivedType>>
       StaticDataMemberCache;
 
+  /// Cache of the ODR identifiers of C++ tag types, keyed by their canonical
+  /// declarations.
+  llvm::DenseMap<const TagDecl *, StringRef> UniqueTagTypeNames;
+  /// Cache of the names of class template specializations, which include
+  /// their template arguments.
+  llvm::DenseMap<const RecordDecl *, StringRef> SpecializationNames;
+
   /// Helper functions for getOrCreateType.
   /// @{
   /// Currently the checksum of an interface includes the number of
@@ -410,6 +418,11 @@ public:
   void completeRequiredType(const RecordDecl *RD);
   void completeClassData(const RecordDecl *RD);
 
+  /// Emit the definition of the class of a constructor that is being
+  /// emitted, if the definition is omitted elsewhere because of constructor
+  /// homing.
+  void completeClassForConstructor(const CXXConstructorDecl *CD);
+
   void completeTemplateDefinition(const ClassTemplateSpecializationDecl &SD);
 
 private:
@@ -528,6 +541,10 @@ private:
   /// Get class name including template argument list.
   StringRef getClassName(const RecordDecl *RD);
 
+  /// Get the identifier under which the type is uniqued across translation
+  /// units, or an empty string if it has none.
+  StringRef getUniqueTagTypeName(const TagType *Ty);
+
   /// Get the vtable name for the given class.
   StringRef getVTableName(const CXXRecordDecl *Decl);
 
@@ -1690,7 +1690,7 @@ void CodeGenFunction::startOutlinedSEHHelper(CodeGenFunction &ParentCGF,
                 OutlinedStmt->getLocStart(), OutlinedStmt->getLocStart());
   CurSEHParent = ParentCGF.CurSEHParent;
 
-  CGM.SetLLVMFunctionAttributes(nullptr, FnInfo, CurFn);
+  CGM.SetLLVMFunctionAttributes(nullptr, FnInfo, CurFn, /*IsThunk=*/false);
   EmitCapturedLocals(ParentCGF, OutlinedStmt, IsFilter);
 }
 
@@ -956,6 +956,17 @@ LValue CodeGenFunction::EmitCheckedLValue(const Expr *E, TypeCheckKind TCK) {
   if (!isa<DeclRefExpr>(E) && !LV.isBitField() && LV.isSimple())
     EmitTypeCheck(TCK, E->getExprLoc(), LV.getPointer(),
                   E->getType(), LV.getAlignment());
+
+  // Local variables are promoted to registers, so their type-based alias
+  // information doesn't matter.
+  bool IsLocal = false;
+  if (const auto *DRE = dyn_cast<DeclRefExpr>(E->IgnoreParens()))
+    if (const auto *VD = dyn_cast<VarDecl>(DRE->getDecl()))
+      IsLocal = VD->hasLocalStorage();
+  if ((TCK == TCK_Load || TCK == TCK_Store) && !IsLocal &&
+      hasScalarEvaluationKind(E->getType()))
+    CGM.remarkConservativeTBAA(E->getExprLoc(), E->getType(),
+                               LV.getTBAAInfo(), TCK == TCK_Store);
   return LV;
 }
 
@@ -595,6 +595,168 @@ llvm::Constant *ConstStructBuilder::BuildStruct(CodeGenModule &CGM,
 }
 
 
+//===----------------------------------------------------------------------===//
+//                           Packed array emission
+//===----------------------------------------------------------------------===//
+
+/// \brief Compute the bit pattern of an array element of type \p EltTy that
+/// is initialized by \p E, if \p E is a (possibly negated) integer, character
+/// or floating-point literal, with at most an implicit arithmetic conversion.
+static bool getLiteralElementBits(ASTContext &Ctx, const Expr *E,
+                                  QualType EltTy, unsigned Width,
+                                  uint64_t &Bits) {
+  E = E->IgnoreParens();
+  const ImplicitCastExpr *Cast = dyn_cast<ImplicitCastExpr>(E);
+  if (Cast)
+    E = Cast->getSubExpr()->IgnoreParens();
+  bool Negate = false;
+  if (const auto *UO = dyn_cast<UnaryOperator>(E)) {
+    if (UO->getOpcode() != UO_Minus)
+      return false;
+    Negate = true;
+    E = UO->getSubExpr()->IgnoreParens();
+  }
+
+  llvm::APSInt IntValue;
+  bool IsInt = true;
+  if (const auto *IL = dyn_cast<IntegerLiteral>(E))
+    IntValue = llvm::APSInt(IL->getValue(),
+                            IL->getType()->isUnsignedIntegerType());
+  else if (const auto *CL = dyn_cast<CharacterLiteral>(E))
+    IntValue = Ctx.MakeIntValue(CL->getValue(), CL->getType());
+  else if (isa<FloatingLiteral>(E))
+    IsInt = false;
+  else
+    return false;
+  if (IsInt && Negate)
+    IntValue = -IntValue;
+
+  if (EltTy->isIntegerType()) {
+    if (!IsInt || (Cast && Cast->getCastKind() != CK_IntegralCast))
+      return false;
+    Bits = IntValue.extOrTrunc(Width).getZExtValue();
+    return true;
+  }
+
+  const llvm::fltSemantics &Sem = Ctx.getFloatTypeSemantics(EltTy);
+  llvm::APFloat FloatValue(Sem);
+  bool LosesInfo;
+  if (const auto *FL = dyn_cast<FloatingLiteral>(E)) {
+    if (Cast && Cast->getCastKind() != CK_FloatingCast)
+      return false;
+    FloatValue = FL->getValue();
+    if (Negate)
+      FloatValue.changeSign();
+    FloatValue.convert(Sem, llvm::APFloat::rmNearestTiesToEven, &LosesInfo);
+  } else {
+    if (!Cast || Cast->getCastKind() != CK_IntegralToFloating)
+      return false;
+    FloatValue.convertFromAPInt(IntValue, IntValue.isSigned(),
+                                llvm::APFloat::rmNearestTiesToEven);
+  }
+  Bits = FloatValue.bitcastToAPInt().getZExtValue();
+  return true;
+}
+
+static llvm::Constant *getDataArray(llvm::LLVMContext &Context,
+                                    ArrayRef<uint8_t> Data, bool IsFloat) {
+  assert(!IsFloat && "no 8-bit floating-point type");
+  return llvm::ConstantDataArray::get(Context, Data);
+}
+
+template <typename T>
+static llvm::Constant *getDataArray(llvm::LLVMContext &Context,
+                                    ArrayRef<T> Data, bool IsFloat) {
+  if (IsFloat)
+    return llvm::ConstantDataArray::getFP(Context, Data);
+  return llvm::ConstantDataArray::get(Context, Data);
+}
+
+template <typename T>
+static llvm::Constant *emitPackedElements(CodeGenModule &CGM,
+                                          const InitListExpr *ILE,
+                                          QualType EltTy, uint64_t NumElements,
+                                          bool IsFloat) {
+  ASTContext &Ctx = CGM.getContext();
+  std::vector<T> Data;
+  Data.reserve(NumElements);
+  for (const Expr *Init : ILE->inits()) {
+    uint64_t Bits = 0;
+    if (!isa<ImplicitValueInitExpr>(Init) &&
+        !getLiteralElementBits(Ctx, Init, EltTy, sizeof(T) * 8, Bits))
+      return nullptr;
+    Data.push_back(T(Bits));
+  }
+  Data.resize(NumElements, T(0));
+  return getDataArray(CGM.getLLVMContext(), ArrayRef<T>(Data), IsFloat);
+}
+
+/// \brief Try to emit the initializer \p Init of an array of type \p DestType
+/// whose elements are all numeric literals (or arrays of them) directly into
+/// ConstantDataArrays.
+///
+/// Generated lookup tables can have millions of elements. Evaluating them
+/// into an APValue, and then creating a constant for each element, takes far
+/// more time and memory than packing the literal values into a buffer.
+static llvm::Constant *tryEmitPackedArrayInit(CodeGenModule &CGM,
+                                              const Expr *Init,
+                                              QualType DestType) {
+  const ConstantArrayType *CAT =
+      CGM.getContext().getAsConstantArrayType(DestType);
+  const auto *ILE = dyn_cast<InitListExpr>(Init->IgnoreParens());
+  if (!CAT || !ILE || ILE->isTransparent())
+    return nullptr;
+
+  uint64_t NumElements = CAT->getSize().getZExtValue();
+  if (ILE->getNumInits() > NumElements)
+    return nullptr;
+  if (const Expr *Filler = ILE->getArrayFiller())
+    if (!isa<ImplicitValueInitExpr>(Filler))
+      return nullptr;
+
+  QualType EltTy = CAT->getElementType();
+  if (EltTy->isConstantArrayType()) {
+    llvm::ArrayType *AType =
+        cast<llvm::ArrayType>(CGM.getTypes().ConvertTypeForMem(DestType));
+    std::vector<llvm::Constant *> Elts;
+    Elts.reserve(NumElements);
+    for (const Expr *SubInit : ILE->inits()) {
+      llvm::Constant *C = isa<ImplicitValueInitExpr>(SubInit)
+                              ? CGM.EmitNullConstant(EltTy)
+                              : tryEmitPackedArrayInit(CGM, SubInit, EltTy);
+      if (!C || C->getType() != AType->getElementType())
+        return nullptr;
+      Elts.push_back(C);
+    }
+    Elts.resize(NumElements, CGM.EmitNullConstant(EltTy));
+    return llvm::ConstantArray::get(AType, Elts);
+  }
+
+  if (EltTy->isBooleanType())
+    return nullptr;
+  if (EltTy->isIntegerType()) {
+    switch (CGM.getContext().getTypeSize(EltTy)) {
+    case 8:
+      return emitPackedElements<uint8_t>(CGM, ILE, EltTy, NumElements, false);
+    case 16:
+      return emitPackedElements<uint16_t>(CGM, ILE, EltTy, NumElements, false);
+    case 32:
+      return emitPackedElements<uint32_t>(CGM, ILE, EltTy, NumElements, false);
+    case 64:
+      return emitPackedElements<uint64_t>(CGM, ILE, EltTy, NumElements, false);
+    }
+    return nullptr;
+  }
+  if (EltTy->isRealFloatingType()) {
+    llvm::Type *EltIRTy = CGM.getTypes().ConvertTypeForMem(EltTy);
+    if (EltIRTy->isFloatTy())
+      return emitPackedElements<uint32_t>(CGM, ILE, EltTy, NumElements, true);
+    if (EltIRTy->isDoubleTy())
+      return emitPackedElements<uint64_t>(CGM, ILE, EltTy, NumElements, true);
+  }
+  return nullptr;
+}
+
 //===----------------------------------------------------------------------===//
 //                             ConstExprEmitter
 //===----------------------------------------------------------------------===//
@@ -780,6 +942,9 @@ public:
   }
 
   llvm::Constant *EmitArrayInitialization(InitListExpr *ILE) {
+    if (llvm::Constant *C = tryEmitPackedArrayInit(CGM, ILE, ILE->getType()))
+      return C;
+
     llvm::ArrayType *AType =
         cast<llvm::ArrayType>(ConvertType(ILE->getType()));
     llvm::Type *ElemTy = AType->getElementType();
@@ -1218,6 +1383,11 @@ llvm::Constant *CodeGenModule::EmitConstantInit(const VarDecl &D,
       }
   }
   
+  // Emit arrays of numeric literals without evaluating them first.
+  if (const Expr *Init = D.getInit())
+    if (llvm::Constant *C = tryEmitPackedArrayInit(*this, Init, D.getType()))
+      return C;
+
   if (const APValue *Value = D.evaluateValue())
     return EmitConstantValueForMemory(*Value, D.getType(), CGF);
 
@@ -1244,6 +1414,9 @@ llvm::Constant *CodeGenModule::EmitConstantInit(const VarDecl &D,
 llvm::Constant *CodeGenModule::EmitConstantExpr(const Expr *E,
                                                 QualType DestType,
                                                 CodeGenFunction *CGF) {
+  if (llvm::Constant *C = tryEmitPackedArrayInit(*this, E, DestType))
+    return C;
+
   Expr::EvalResult Result;
 
   bool Success = false;
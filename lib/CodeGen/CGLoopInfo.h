@@ -60,6 +60,21 @@ struct LoopAttributes {
 
   /// \brief Value for llvm.loop.distribute.enable metadata.
   LVEnableState DistributeEnable;
+
+  /// \brief Value for llvm.loop.unroll_and_jam.* metadata (enable or disable).
+  LVEnableState UnrollAndJamEnable;
+
+  /// \brief Value for llvm.loop.unroll_and_jam.count metadata.
+  unsigned UnrollAndJamCount;
+
+  /// \brief Value for llvm.loop.vectorize.predicate.enable metadata.
+  LVEnableState VectorizePredicateEnable;
+
+  /// \brief Generate llvm.loop.pipeline.disable metadata.
+  bool PipelineDisabled;
+
+  /// \brief Value for llvm.loop.pipeline.initiationinterval metadata.
+  unsigned PipelineInitiationInterval;
 };
 
 /// \brief Information used when generating a structured loop.
@@ -152,6 +167,29 @@ public:
   /// \brief Set the unroll count for the next loop pushed.
   void setUnrollCount(unsigned C) { StagedAttrs.UnrollCount = C; }
 
+  /// \brief Set the next pushed loop unroll_and_jam state.
+  void setUnrollAndJamState(const LoopAttributes::LVEnableState &State) {
+    StagedAttrs.UnrollAndJamEnable = State;
+  }
+
+  /// \brief Set the unroll-and-jam count for the next loop pushed.
+  void setUnrollAndJamCount(unsigned C) { StagedAttrs.UnrollAndJamCount = C; }
+
+  /// \brief Set the next pushed loop 'vectorize.predicate.enable'.
+  void setVectorizePredicateState(const LoopAttributes::LVEnableState &State) {
+    StagedAttrs.VectorizePredicateEnable = State;
+  }
+
+  /// \brief Set whether software pipelining is disabled for the next loop
+  /// pushed.
+  void setPipelineDisabled(bool S) { StagedAttrs.PipelineDisabled = S; }
+
+  /// \brief Set the software pipelining initiation interval for the next loop
+  /// pushed.
+  void setPipelineInitiationInterval(unsigned C) {
+    StagedAttrs.PipelineInitiationInterval = C;
+  }
+
 private:
   /// \brief Returns true if there is LoopInfo on the stack.
   bool hasInfo() const { return !Active.empty(); }
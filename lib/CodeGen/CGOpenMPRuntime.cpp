@@ -19,6 +19,7 @@
 #include "clang/AST/Decl.h"
 #include "clang/AST/StmtOpenMP.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/Bitcode/BitcodeReader.h"
 #include "llvm/IR/CallSite.h"
 #include "llvm/IR/DerivedTypes.h"
@@ -643,6 +644,10 @@ enum OpenMPRTLFunction {
   // Call to void __kmpc_doacross_wait(ident_t *loc, kmp_int32 gtid, kmp_int64
   // *vec);
   OMPRTL__kmpc_doacross_wait,
+  // Call to int omp_get_thread_num(void);
+  OMPRTL_omp_get_thread_num,
+  // Call to int omp_get_num_threads(void);
+  OMPRTL_omp_get_num_threads,
 
   //
   // Offloading related calls
@@ -1537,6 +1542,20 @@ CGOpenMPRuntime::createRuntimeFunction(unsigned Function) {
     RTLFn = CGM.CreateRuntimeFunction(FnTy, /*Name=*/"__kmpc_doacross_wait");
     break;
   }
+  case OMPRTL_omp_get_thread_num: {
+    // Build int omp_get_thread_num(void);
+    llvm::FunctionType *FnTy =
+        llvm::FunctionType::get(CGM.IntTy, /*isVarArg*/ false);
+    RTLFn = CGM.CreateRuntimeFunction(FnTy, "omp_get_thread_num");
+    break;
+  }
+  case OMPRTL_omp_get_num_threads: {
+    // Build int omp_get_num_threads(void);
+    llvm::FunctionType *FnTy =
+        llvm::FunctionType::get(CGM.IntTy, /*isVarArg*/ false);
+    RTLFn = CGM.CreateRuntimeFunction(FnTy, "omp_get_num_threads");
+    break;
+  }
   case OMPRTL__tgt_target: {
     // Build int32_t __tgt_target(int32_t device_id, void *host_ptr, int32_t
     // arg_num, void** args_base, void **args, size_t *arg_sizes, int32_t
@@ -2405,6 +2424,15 @@ bool CGOpenMPRuntime::isStaticNonchunked(
   return Schedule == OMP_dist_sch_static;
 }
 
+bool CGOpenMPRuntime::isStaticScheduleInlined(
+    OpenMPScheduleClauseKind ScheduleKind, bool Chunked, bool Ordered) const {
+  if (!CGM.getLangOpts().OpenMPInlineStaticSchedule ||
+      CGM.getLangOpts().OpenMPIsDevice)
+    return false;
+  auto Schedule = getRuntimeSchedule(ScheduleKind, Chunked, Ordered);
+  return Schedule == OMP_sch_static;
+}
+
 
 bool CGOpenMPRuntime::isDynamic(OpenMPScheduleClauseKind ScheduleKind) const {
   auto Schedule =
@@ -2531,6 +2559,54 @@ static void emitForStaticInitCall(
    CGF.EmitRuntimeCall(ForStaticInitFunction, Args);
 }
 
+/// \brief Compute the bounds of the calling thread's chunk of a static
+/// non-chunked loop inline, the way __kmpc_for_static_init does for the
+/// runtime's default (greedy) static schedule: the iterations are split into
+/// chunks of trip_count / num_threads iterations, rounded up, and thread
+/// \a ThreadNum gets the chunk with that number. Threads without a chunk get
+/// a lower bound past the end of the loop.
+static void emitInlineStaticInit(CodeGenFunction &CGF, llvm::Value *ThreadNum,
+                                 llvm::Value *NumThreads, unsigned IVSize,
+                                 bool IVSigned, Address IL, Address LB,
+                                 Address UB, Address ST) {
+  auto &Builder = CGF.Builder;
+  auto *IVTy = Builder.getIntNTy(IVSize);
+  auto *Zero = llvm::ConstantInt::get(IVTy, 0);
+  auto *One = llvm::ConstantInt::get(IVTy, 1);
+  auto *Tid = Builder.CreateIntCast(ThreadNum, IVTy, /*isSigned=*/true);
+  auto *NThreads = Builder.CreateIntCast(NumThreads, IVTy, /*isSigned=*/true);
+
+  // trip_count = UB - LB + 1;
+  auto *Lower = Builder.CreateLoad(LB);
+  auto *Upper = Builder.CreateLoad(UB);
+  auto *TripCount = Builder.CreateAdd(Builder.CreateSub(Upper, Lower), One,
+                                      "omp.trip_count");
+  // chunk = trip_count / nthreads + (trip_count % nthreads != 0);
+  auto *HasRemainder =
+      Builder.CreateICmpNE(Builder.CreateURem(TripCount, NThreads), Zero);
+  auto *Quotient = Builder.CreateUDiv(TripCount, NThreads);
+  auto *Chunk = Builder.CreateAdd(
+      Quotient, Builder.CreateZExt(HasRemainder, IVTy), "omp.chunk");
+  // LB = LB + tid * chunk;
+  // UB = LB + chunk - 1, saturated if it overflows.
+  auto *NewLower = Builder.CreateAdd(Lower, Builder.CreateMul(Tid, Chunk));
+  auto *NewUpper = Builder.CreateSub(Builder.CreateAdd(NewLower, Chunk), One);
+  auto *Overflow = IVSigned ? Builder.CreateICmpSLT(NewUpper, NewLower)
+                            : Builder.CreateICmpULT(NewUpper, NewLower);
+  auto *Max = llvm::ConstantInt::get(
+      IVTy, IVSigned ? llvm::APInt::getSignedMaxValue(IVSize)
+                     : llvm::APInt::getMaxValue(IVSize));
+  NewUpper = Builder.CreateSelect(Overflow, Max, NewUpper);
+  // IL = tid == (trip_count - 1) / chunk;
+  auto *IsLast = Builder.CreateICmpEQ(
+      Tid, Builder.CreateUDiv(Builder.CreateSub(TripCount, One), Chunk));
+
+  Builder.CreateStore(NewLower, LB);
+  Builder.CreateStore(NewUpper, UB);
+  Builder.CreateStore(TripCount, ST);
+  Builder.CreateStore(Builder.CreateZExt(IsLast, CGF.Int32Ty), IL);
+}
+
 void CGOpenMPRuntime::emitForStaticInit(CodeGenFunction &CGF,
                                         SourceLocation Loc,
                                         const OpenMPScheduleTy &ScheduleKind,
@@ -2538,6 +2614,18 @@ void CGOpenMPRuntime::emitForStaticInit(CodeGenFunction &CGF,
                                         bool Ordered, Address IL, Address LB,
                                         Address UB, Address ST,
                                         llvm::Value *Chunk) {
+  if (isStaticScheduleInlined(ScheduleKind.Schedule, Chunk != nullptr,
+                              Ordered)) {
+    if (!CGF.HaveInsertPoint())
+      return;
+    auto *ThreadNum =
+        CGF.EmitRuntimeCall(createRuntimeFunction(OMPRTL_omp_get_thread_num));
+    auto *NumThreads =
+        CGF.EmitRuntimeCall(createRuntimeFunction(OMPRTL_omp_get_num_threads));
+    emitInlineStaticInit(CGF, ThreadNum, NumThreads, IVSize, IVSigned, IL, LB,
+                         UB, ST);
+    return;
+  }
   OpenMPSchedType ScheduleNum =
       getRuntimeSchedule(ScheduleKind.Schedule, Chunk != nullptr, Ordered);
   auto *UpdatedLocation = emitUpdateLocation(CGF, Loc);
@@ -5897,6 +5985,55 @@ static void emitOffloadingArraysArgument(
   }
 }
 
+namespace {
+/// Offloading operations reported to the instrumentation hooks. The values
+/// are part of the interface of the hooks.
+enum OffloadInstrumentKind {
+  /// Mapping of the data of a target region, its execution on the device, and
+  /// the unmapping of its data.
+  OIK_TargetRegion = 0,
+  /// Opening of a data environment, or 'target enter data'.
+  OIK_DataBegin = 1,
+  /// Closing of a data environment, or 'target exit data'.
+  OIK_DataEnd = 2,
+  /// 'target update'.
+  OIK_DataUpdate = 3,
+  /// Execution of a target region on the host after offloading failed or
+  /// was disabled.
+  OIK_HostFallback = 4,
+};
+} // anonymous namespace
+
+/// With -fopenmp-instrument-offload, emit a call to the hook
+///   void __omp_offload_instrument_{enter,exit}(int32_t kind, const char *loc)
+/// where \a loc is the "file:line:column" of the directive \a D.
+static void emitOffloadInstrumentation(CodeGenFunction &CGF,
+                                       const OMPExecutableDirective &D,
+                                       OffloadInstrumentKind Kind,
+                                       bool IsEnter) {
+  CodeGenModule &CGM = CGF.CGM;
+  if (!CGM.getLangOpts().OpenMPInstrumentOffload || !CGF.HaveInsertPoint())
+    return;
+
+  std::string Loc = "unknown";
+  PresumedLoc PLoc =
+      CGM.getContext().getSourceManager().getPresumedLoc(D.getLocStart());
+  if (PLoc.isValid())
+    Loc = (Twine(PLoc.getFilename()) + ":" + Twine(PLoc.getLine()) + ":" +
+           Twine(PLoc.getColumn()))
+              .str();
+
+  llvm::Type *Params[] = {CGM.Int32Ty, CGM.Int8PtrTy};
+  auto *FnTy = llvm::FunctionType::get(CGM.VoidTy, Params, /*isVarArg=*/false);
+  llvm::Constant *Hook = CGM.CreateRuntimeFunction(
+      FnTy, IsEnter ? "__omp_offload_instrument_enter"
+                    : "__omp_offload_instrument_exit");
+  llvm::Value *Args[] = {
+      CGF.Builder.getInt32(Kind),
+      CGM.GetAddrOfConstantCString(Loc).getPointer()};
+  CGF.EmitRuntimeCall(Hook, Args);
+}
+
 void CGOpenMPRuntime::emitTargetCall(CodeGenFunction &CGF,
                                      const OMPExecutableDirective &D,
                                      llvm::Value *OutlinedFn,
@@ -6030,6 +6167,7 @@ void CGOpenMPRuntime::emitTargetCall(CodeGenFunction &CGF,
     // of having any clauses associated. If the user is using teams but no
     // clauses, these two values will be the default that should be passed to
     // the runtime library - a 32-bit integer with the value zero.
+    emitOffloadInstrumentation(CGF, D, OIK_TargetRegion, /*IsEnter=*/true);
     if (NumTeams) {
       assert(ThreadLimit && "Thread limit expression should be available along "
                             "with number of teams.");
@@ -6050,6 +6188,7 @@ void CGOpenMPRuntime::emitTargetCall(CodeGenFunction &CGF,
       Return = CGF.EmitRuntimeCall(RT.createRuntimeFunction(OMPRTL__tgt_target),
                                    OffloadingArgs);
     }
+    emitOffloadInstrumentation(CGF, D, OIK_TargetRegion, /*IsEnter=*/false);
 
     CGF.EmitStoreOfScalar(Return, OffloadError);
   };
@@ -6084,7 +6223,9 @@ void CGOpenMPRuntime::emitTargetCall(CodeGenFunction &CGF,
   CGF.Builder.CreateCondBr(Failed, OffloadFailedBlock, OffloadContBlock);
 
   CGF.EmitBlock(OffloadFailedBlock);
+  emitOffloadInstrumentation(CGF, D, OIK_HostFallback, /*IsEnter=*/true);
   CGF.Builder.CreateCall(OutlinedFn, KernelArgs);
+  emitOffloadInstrumentation(CGF, D, OIK_HostFallback, /*IsEnter=*/false);
   CGF.EmitBranch(OffloadContBlock);
 
   CGF.EmitBlock(OffloadContBlock, /*IsFinished=*/true);
@@ -6308,8 +6449,10 @@ void CGOpenMPRuntime::emitTargetDataCalls(
         DeviceID,         PointerNum,    BasePointersArrayArg,
         PointersArrayArg, SizesArrayArg, MapTypesArrayArg};
     auto &RT = CGF.CGM.getOpenMPRuntime();
+    emitOffloadInstrumentation(CGF, D, OIK_DataBegin, /*IsEnter=*/true);
     CGF.EmitRuntimeCall(RT.createRuntimeFunction(OMPRTL__tgt_target_data_begin),
                         OffloadingArgs);
+    emitOffloadInstrumentation(CGF, D, OIK_DataBegin, /*IsEnter=*/false);
 
     // If device pointer privatization is required, emit the body of the region
     // here. It will have to be duplicated: with and without privatization.
@@ -6318,8 +6461,8 @@ void CGOpenMPRuntime::emitTargetDataCalls(
   };
 
   // Generate code for the closing of the data region.
-  auto &&EndThenGen = [&CGF, Device, &Info](CodeGenFunction &CGF,
-                                            PrePostActionTy &) {
+  auto &&EndThenGen = [&D, &CGF, Device, &Info](CodeGenFunction &CGF,
+                                                PrePostActionTy &) {
     assert(Info.isValid() && "Invalid data environment closing arguments.");
 
     llvm::Value *BasePointersArrayArg = nullptr;
@@ -6344,8 +6487,10 @@ void CGOpenMPRuntime::emitTargetDataCalls(
         DeviceID,         PointerNum,    BasePointersArrayArg,
         PointersArrayArg, SizesArrayArg, MapTypesArrayArg};
     auto &RT = CGF.CGM.getOpenMPRuntime();
+    emitOffloadInstrumentation(CGF, D, OIK_DataEnd, /*IsEnter=*/true);
     CGF.EmitRuntimeCall(RT.createRuntimeFunction(OMPRTL__tgt_target_data_end),
                         OffloadingArgs);
+    emitOffloadInstrumentation(CGF, D, OIK_DataEnd, /*IsEnter=*/false);
   };
 
   // If we need device pointer privatization, we need to emit the body of the
@@ -6434,21 +6579,27 @@ void CGOpenMPRuntime::emitTargetDataStandAloneCall(
     // Select the right runtime function call for each expected standalone
     // directive.
     OpenMPRTLFunction RTLFn;
+    OffloadInstrumentKind InstrumentKind;
     switch (D.getDirectiveKind()) {
     default:
       llvm_unreachable("Unexpected standalone target data directive.");
       break;
     case OMPD_target_enter_data:
       RTLFn = OMPRTL__tgt_target_data_begin;
+      InstrumentKind = OIK_DataBegin;
       break;
     case OMPD_target_exit_data:
       RTLFn = OMPRTL__tgt_target_data_end;
+      InstrumentKind = OIK_DataEnd;
       break;
     case OMPD_target_update:
       RTLFn = OMPRTL__tgt_target_data_update;
+      InstrumentKind = OIK_DataUpdate;
       break;
     }
+    emitOffloadInstrumentation(CGF, D, InstrumentKind, /*IsEnter=*/true);
     CGF.EmitRuntimeCall(RT.createRuntimeFunction(RTLFn), OffloadingArgs);
+    emitOffloadInstrumentation(CGF, D, InstrumentKind, /*IsEnter=*/false);
   };
 
   // In the event we get an if clause, we don't have to take any action on the
@@ -6526,27 +6677,234 @@ static unsigned evaluateCDTSize(const FunctionDecl *FD,
   return C.getTypeSize(CDT);
 }
 
+/// Return true if values of type \a Ty can be passed in the lanes of the
+/// vector arguments and return value of a vector variant.
+static bool isVectorLaneType(llvm::Type *Ty) {
+  return (Ty->isIntegerTy() && !Ty->isIntegerTy(1)) || Ty->isFloatTy() ||
+         Ty->isDoubleTy() || Ty->isPointerTy();
+}
+
+/// Emit the vector variant \a Name of the 'declare simd' function \a Fn.
+///
+/// The variant calls \a Fn for each active lane of its vector arguments in
+/// turn, passing the lane of each vector argument, the value of each linear
+/// argument for the lane, and the uniform arguments unchanged. Once \a Fn is
+/// inlined into it, the loop over the lanes can be vectorized for the ISA of
+/// the variant, which makes the variant usable from vectorized loops in other
+/// translation units, whether they are compiled from C or Fortran.
+///
+/// \param FnAttrs Function attributes of \a Fn to copy to the variant.
+/// \param Features The target features of the ISA of the variant.
+/// \param MaskTy Type of the mask argument of a masked variant, either a
+/// vector of VLEN elements or an integer of VLEN bits, or null for a variant
+/// without a mask.
+static void emitX86DeclareSimdVariant(CodeGenModule &CGM, llvm::Function *Fn,
+                                      llvm::AttributeSet FnAttrs,
+                                      StringRef Name, StringRef Features,
+                                      unsigned VLEN, llvm::Type *MaskTy,
+                                      ArrayRef<ParamAttrTy> ParamAttrs) {
+  llvm::Module &M = CGM.getModule();
+  if (M.getFunction(Name))
+    return;
+
+  // Vector arguments and the return value are passed in vectors of VLEN
+  // elements, the other arguments as they are passed to the scalar function.
+  llvm::FunctionType *ScalarTy = Fn->getFunctionType();
+  SmallVector<llvm::Type *, 8> ParamTys;
+  for (unsigned I = 0, E = ParamAttrs.size(); I < E; ++I) {
+    llvm::Type *Ty = ScalarTy->getParamType(I);
+    switch (ParamAttrs[I].Kind) {
+    case Vector:
+      if (!isVectorLaneType(Ty))
+        return;
+      ParamTys.push_back(llvm::VectorType::get(Ty, VLEN));
+      break;
+    case LinearWithVarStride: {
+      unsigned StridePos = ParamAttrs[I].StrideOrArg.getZExtValue();
+      if (StridePos >= E || !ScalarTy->getParamType(StridePos)->isIntegerTy())
+        return;
+      // Fall through.
+    }
+    case Linear:
+      if (!Ty->isIntegerTy() && !Ty->isPointerTy())
+        return;
+      ParamTys.push_back(Ty);
+      break;
+    case Uniform:
+      ParamTys.push_back(Ty);
+      break;
+    }
+  }
+  if (MaskTy)
+    ParamTys.push_back(MaskTy);
+  llvm::Type *RetTy = ScalarTy->getReturnType();
+  llvm::Type *VecRetTy = RetTy;
+  if (!RetTy->isVoidTy()) {
+    if (!isVectorLaneType(RetTy))
+      return;
+    VecRetTy = llvm::VectorType::get(RetTy, VLEN);
+  }
+
+  auto *Variant = llvm::Function::Create(
+      llvm::FunctionType::get(VecRetTy, ParamTys, /*isVarArg=*/false),
+      Fn->getLinkage(), Name, &M);
+  Variant->setVisibility(Fn->getVisibility());
+  Variant->setComdat(Fn->getComdat());
+  Variant->addAttributes(llvm::AttributeSet::FunctionIndex, FnAttrs);
+  Variant->addFnAttr("target-features", Features);
+
+  llvm::LLVMContext &Ctx = M.getContext();
+  auto *EntryBB = llvm::BasicBlock::Create(Ctx, "entry", Variant);
+  auto *LaneBB = llvm::BasicBlock::Create(Ctx, "simd.lane", Variant);
+  auto *NextBB = llvm::BasicBlock::Create(Ctx, "simd.lane.next", Variant);
+  auto *EndBB = llvm::BasicBlock::Create(Ctx, "simd.lane.end", Variant);
+  llvm::IRBuilder<> Builder(EntryBB);
+
+  // Keep the vectors in memory, so that their lanes can be indexed by the
+  // lane number.
+  auto EmitLaneArray = [&Builder](llvm::Value *Vec, const Twine &Name) {
+    llvm::Value *Addr = Builder.CreateAlloca(Vec->getType(), nullptr, Name);
+    Builder.CreateStore(Vec, Addr);
+    return Builder.CreateBitCast(
+        Addr, Vec->getType()->getVectorElementType()->getPointerTo());
+  };
+  SmallVector<llvm::Value *, 8> Args;
+  SmallVector<llvm::Value *, 8> LaneArrays;
+  for (llvm::Argument &Arg : Variant->args()) {
+    Args.push_back(&Arg);
+    LaneArrays.push_back(Arg.getType()->isVectorTy()
+                             ? EmitLaneArray(&Arg, "simd.arg")
+                             : nullptr);
+  }
+  llvm::Value *RetAddr = nullptr;
+  llvm::Value *RetArray = nullptr;
+  if (!RetTy->isVoidTy()) {
+    RetAddr = Builder.CreateAlloca(VecRetTy, nullptr, "simd.ret");
+    RetArray = Builder.CreateBitCast(RetAddr, RetTy->getPointerTo());
+  }
+  Builder.CreateBr(LaneBB);
+
+  Builder.SetInsertPoint(LaneBB);
+  llvm::PHINode *Lane = Builder.CreatePHI(Builder.getInt32Ty(), 2, "lane");
+  Lane->addIncoming(Builder.getInt32(0), EntryBB);
+  if (MaskTy) {
+    // Skip the lanes that are masked out. A mask of integer type has a bit
+    // for each lane.
+    auto *BodyBB = llvm::BasicBlock::Create(Ctx, "simd.lane.body", Variant,
+                                            NextBB);
+    llvm::Value *MaskLane;
+    if (MaskTy->isVectorTy())
+      MaskLane = Builder.CreateLoad(Builder.CreateGEP(LaneArrays.back(), Lane));
+    else
+      MaskLane = Builder.CreateAnd(
+          Builder.CreateLShr(Args.back(),
+                             Builder.CreateZExtOrTrunc(Lane, MaskTy)),
+          1);
+    llvm::Value *IsActive = Builder.CreateIsNotNull(MaskLane);
+    Builder.CreateCondBr(IsActive, BodyBB, NextBB);
+    Builder.SetInsertPoint(BodyBB);
+  }
+
+  SmallVector<llvm::Value *, 8> CallArgs;
+  for (unsigned I = 0, E = ParamAttrs.size(); I < E; ++I) {
+    const ParamAttrTy &ParamAttr = ParamAttrs[I];
+    llvm::Value *Arg = Args[I];
+    if (ParamAttr.Kind == Vector) {
+      Arg = Builder.CreateLoad(Builder.CreateGEP(LaneArrays[I], Lane));
+    } else if (ParamAttr.Kind != Uniform) {
+      // The value of a linear argument advances by its stride in each lane.
+      // The constant stride of a pointer is in bytes, a variable one in
+      // elements.
+      llvm::Type *OffsetTy = Arg->getType()->isPointerTy()
+                                 ? Builder.getInt64Ty()
+                                 : Arg->getType();
+      llvm::Value *Stride;
+      if (ParamAttr.Kind == LinearWithVarStride)
+        Stride = Builder.CreateSExtOrTrunc(
+            Args[ParamAttr.StrideOrArg.getZExtValue()], OffsetTy);
+      else if (!ParamAttr.StrideOrArg)
+        Stride = llvm::ConstantInt::get(OffsetTy, 1);
+      else
+        Stride = llvm::ConstantInt::get(
+            OffsetTy, ParamAttr.StrideOrArg.getExtValue(), /*isSigned=*/true);
+      llvm::Value *Offset =
+          Builder.CreateMul(Builder.CreateZExtOrTrunc(Lane, OffsetTy), Stride);
+      if (!Arg->getType()->isPointerTy())
+        Arg = Builder.CreateAdd(Arg, Offset);
+      else if (ParamAttr.Kind == LinearWithVarStride)
+        Arg = Builder.CreateGEP(Arg, Offset);
+      else
+        Arg = Builder.CreateBitCast(
+            Builder.CreateGEP(Builder.CreateBitCast(Arg, Builder.getInt8PtrTy(
+                                  Arg->getType()->getPointerAddressSpace())),
+                              Offset),
+            Arg->getType());
+    }
+    CallArgs.push_back(Arg);
+  }
+  llvm::CallInst *Call = Builder.CreateCall(Fn, CallArgs);
+  Call->setCallingConv(Fn->getCallingConv());
+  Call->setAttributes(Fn->getAttributes().removeAttributes(
+      Ctx, llvm::AttributeSet::FunctionIndex,
+      Fn->getAttributes().getFnAttributes()));
+  if (RetArray)
+    Builder.CreateStore(Call, Builder.CreateGEP(RetArray, Lane));
+  Builder.CreateBr(NextBB);
+
+  Builder.SetInsertPoint(NextBB);
+  llvm::Value *NextLane = Builder.CreateAdd(Lane, Builder.getInt32(1),
+                                            "lane.next", /*HasNUW=*/true);
+  Lane->addIncoming(NextLane, NextBB);
+  Builder.CreateCondBr(Builder.CreateICmpEQ(NextLane, Builder.getInt32(VLEN)),
+                       EndBB, LaneBB);
+
+  Builder.SetInsertPoint(EndBB);
+  if (RetAddr)
+    Builder.CreateRet(Builder.CreateLoad(RetAddr));
+  else
+    Builder.CreateRetVoid();
+}
+
+/// Compute the target features of the functions of an ISA, which are the
+/// features of the translation unit with \a ISAFeature enabled.
+static std::string getISAFeatures(CodeGenModule &CGM, StringRef ISAFeature) {
+  const TargetInfo &Target = CGM.getTarget();
+  std::vector<std::string> FeatureVec = Target.getTargetOpts().Features;
+  FeatureVec.push_back(ISAFeature.str());
+  llvm::StringMap<bool> FeatureMap;
+  Target.initFeatureMap(FeatureMap, CGM.getDiags(), Target.getTargetOpts().CPU,
+                        FeatureVec);
+
+  std::vector<std::string> Features;
+  for (const auto &Feature : FeatureMap)
+    Features.push_back((Feature.second ? "+" : "-") + Feature.first().str());
+  std::sort(Features.begin(), Features.end());
+  return llvm::join(Features.begin(), Features.end(), ",");
+}
+
 static void
-emitX86DeclareSimdFunction(const FunctionDecl *FD, llvm::Function *Fn,
-                           const llvm::APSInt &VLENVal,
+emitX86DeclareSimdFunction(CodeGenModule &CGM, const FunctionDecl *FD,
+                           llvm::Function *Fn, llvm::AttributeSet FnAttrs,
+                           bool EmitVariants, const llvm::APSInt &VLENVal,
                            ArrayRef<ParamAttrTy> ParamAttrs,
                            OMPDeclareSimdDeclAttr::BranchStateTy State) {
   struct ISADataTy {
     char ISA;
     unsigned VecRegSize;
+    const char *Feature;
   };
   ISADataTy ISAData[] = {
       {
-          'b', 128
+          'b', 128, "+sse2"
       }, // SSE
       {
-          'c', 256
+          'c', 256, "+avx"
       }, // AVX
       {
-          'd', 256
+          'd', 256, "+avx2"
       }, // AVX2
       {
-          'e', 512
+          'e', 512, "+avx512f"
       }, // AVX512
   };
   llvm::SmallVector<char, 2> Masked;
@@ -6562,16 +6920,16 @@ emitX86DeclareSimdFunction(const FunctionDecl *FD, llvm::Function *Fn,
     Masked.push_back('M');
     break;
   }
+  unsigned CDTSize = evaluateCDTSize(FD, ParamAttrs);
   for (auto Mask : Masked) {
     for (auto &Data : ISAData) {
       SmallString<256> Buffer;
       llvm::raw_svector_ostream Out(Buffer);
       Out << "_ZGV" << Data.ISA << Mask;
-      if (!VLENVal) {
-        Out << llvm::APSInt::getUnsigned(Data.VecRegSize /
-                                         evaluateCDTSize(FD, ParamAttrs));
-      } else
-        Out << VLENVal;
+      llvm::APSInt VLEN = VLENVal;
+      if (!VLENVal)
+        VLEN = llvm::APSInt::getUnsigned(Data.VecRegSize / CDTSize);
+      Out << VLEN;
       for (auto &ParamAttr : ParamAttrs) {
         switch (ParamAttr.Kind){
         case LinearWithVarStride:
@@ -6594,10 +6952,63 @@ emitX86DeclareSimdFunction(const FunctionDecl *FD, llvm::Function *Fn,
       }
       Out << '_' << Fn->getName();
       Fn->addFnAttr(Out.str());
+
+      // Don't emit variants for absurdly wide vectors.
+      if (!EmitVariants || !VLEN || VLEN.getActiveBits() > 16)
+        continue;
+      // The mask of an AVX-512 variant is an integer with a bit for each
+      // lane, passed in a general purpose register. The masks of the other
+      // variants are vectors of the characteristic data type.
+      llvm::Type *MaskTy = nullptr;
+      if (Mask == 'M') {
+        if (Data.ISA == 'e') {
+          if (VLEN.getZExtValue() > 64)
+            continue;
+          MaskTy = llvm::Type::getIntNTy(CGM.getLLVMContext(),
+                                         VLEN.getZExtValue());
+        } else {
+          MaskTy = llvm::VectorType::get(
+              llvm::Type::getIntNTy(CGM.getLLVMContext(), CDTSize),
+              VLEN.getZExtValue());
+        }
+      }
+      emitX86DeclareSimdVariant(CGM, Fn, FnAttrs, Out.str(),
+                                getISAFeatures(CGM, Data.Feature),
+                                VLEN.getZExtValue(), MaskTy, ParamAttrs);
     }
   }
 }
 
+/// Return true if the vector variants of \a FD can be emitted: all of its
+/// parameters and its return type must be scalars that are passed directly,
+/// and linear references must have the 'ref' modifier, so that the variant
+/// can pass each lane's reference to the scalar function.
+static bool canEmitDeclareSimdVariants(const FunctionDecl *FD,
+                                       llvm::Function *Fn,
+                                       unsigned NumParams) {
+  if (Fn->hasAvailableExternallyLinkage() || Fn->isVarArg() ||
+      Fn->arg_size() != NumParams)
+    return false;
+
+  auto IsSimpleType = [](QualType Ty) {
+    return Ty->isIntegralOrEnumerationType() || Ty->isRealFloatingType() ||
+           Ty->isPointerType() || Ty->isReferenceType();
+  };
+  QualType RetTy = FD->getReturnType();
+  if (!RetTy->isVoidType() && !IsSimpleType(RetTy))
+    return false;
+  for (const ParmVarDecl *PVD : FD->parameters())
+    if (!IsSimpleType(PVD->getType()))
+      return false;
+
+  // Arguments that are passed in memory would need a copy for each lane.
+  for (unsigned I = 0; I < NumParams; ++I)
+    if (Fn->getAttributes().hasAttribute(I + 1, llvm::Attribute::ByVal) ||
+        Fn->getAttributes().hasAttribute(I + 1, llvm::Attribute::InAlloca))
+      return false;
+  return true;
+}
+
 void CGOpenMPRuntime::emitDeclareSimdFunction(const FunctionDecl *FD,
                                               llvm::Function *Fn) {
   ASTContext &C = CGM.getContext();
@@ -6611,6 +7022,11 @@ void CGOpenMPRuntime::emitDeclareSimdFunction(const FunctionDecl *FD,
     ParamPositions.insert({P->getCanonicalDecl(), ParamPos});
     ++ParamPos;
   }
+  // The variants get the attributes of the scalar function, but not the
+  // names of the variants that are added to it below.
+  llvm::AttributeSet FnAttrs = Fn->getAttributes().getFnAttributes();
+  bool CanEmitVariants =
+      canEmitDeclareSimdVariants(FD, Fn, ParamPositions.size());
   for (auto *Attr : FD->specific_attrs<OMPDeclareSimdDeclAttr>()) {
     llvm::SmallVector<ParamAttrTy, 8> ParamAttrs(ParamPositions.size());
     // Mark uniform parameters.
@@ -6651,15 +7067,23 @@ void CGOpenMPRuntime::emitDeclareSimdFunction(const FunctionDecl *FD,
     // Mark linear parameters.
     auto SI = Attr->steps_begin();
     auto MI = Attr->modifiers_begin();
+    bool EmitVariants = CanEmitVariants;
     for (auto *E : Attr->linears()) {
       E = E->IgnoreParenImpCasts();
       unsigned Pos;
-      if (isa<CXXThisExpr>(E))
+      QualType ParmTy;
+      if (isa<CXXThisExpr>(E)) {
         Pos = ParamPositions[FD];
-      else {
+        ParmTy = E->getType();
+      } else {
         auto *PVD = cast<ParmVarDecl>(cast<DeclRefExpr>(E)->getDecl())
                         ->getCanonicalDecl();
         Pos = ParamPositions[PVD];
+        ParmTy = PVD->getType();
+        // A reference whose value rather than address is linear would need
+        // a separate object for each lane.
+        if (PVD->getType()->isReferenceType() && *MI != OMPC_LINEAR_ref)
+          EmitVariants = false;
       }
       auto &ParamAttr = ParamAttrs[Pos];
       ParamAttr.Kind = Linear;
@@ -6675,6 +7099,21 @@ void CGOpenMPRuntime::emitDeclareSimdFunction(const FunctionDecl *FD,
           }
         }
       }
+      // The constant step of a pointer is in bytes in the vector function
+      // ABI, as GCC mangles it.
+      if (const auto *PtrTy = ParmTy->getAs<PointerType>()) {
+        QualType PointeeTy = PtrTy->getPointeeType();
+        if (!PointeeTy->isObjectType() || PointeeTy->isIncompleteType() ||
+            !PointeeTy->isConstantSizeType()) {
+          EmitVariants = false;
+        } else if (ParamAttr.Kind == Linear) {
+          int64_t Size = C.getTypeSizeInChars(PointeeTy).getQuantity();
+          int64_t Step =
+              !ParamAttr.StrideOrArg ? 1 : ParamAttr.StrideOrArg.getExtValue();
+          if (Size != 1)
+            ParamAttr.StrideOrArg = llvm::APSInt::get(Step * Size);
+        }
+      }
       ++SI;
       ++MI;
     }
@@ -6684,7 +7123,8 @@ void CGOpenMPRuntime::emitDeclareSimdFunction(const FunctionDecl *FD,
     OMPDeclareSimdDeclAttr::BranchStateTy State = Attr->getBranchState();
     if (CGM.getTriple().getArch() == llvm::Triple::x86 ||
         CGM.getTriple().getArch() == llvm::Triple::x86_64)
-      emitX86DeclareSimdFunction(FD, Fn, VLENVal, ParamAttrs, State);
+      emitX86DeclareSimdFunction(CGM, FD, Fn, FnAttrs, EmitVariants, VLENVal,
+                                 ParamAttrs, State);
   }
 }
 
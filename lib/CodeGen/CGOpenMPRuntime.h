@@ -653,6 +653,17 @@ public:
   virtual bool isStaticNonchunked(OpenMPDistScheduleClauseKind ScheduleKind,
                                   bool Chunked) const;
 
+  /// \brief Check if the bounds of a worksharing loop with the specified
+  /// \a ScheduleKind are computed inline by emitForStaticInit rather than by
+  /// the runtime (see -fopenmp-inline-static-schedule). Such loops need no
+  /// emitForStaticFinish call.
+  /// \param ScheduleKind Schedule kind specified in the 'schedule' clause.
+  /// \param Chunked True if chunk is specified in the clause.
+  /// \param Ordered true if loop is ordered, false otherwise.
+  ///
+  virtual bool isStaticScheduleInlined(OpenMPScheduleClauseKind ScheduleKind,
+                                       bool Chunked, bool Ordered) const;
+
   /// \brief Check if the specified \a ScheduleKind is dynamic.
   /// This kind of worksharing directive is emitted without outer loop.
   /// \param ScheduleKind Schedule Kind specified in the 'schedule' clause.
@@ -2198,9 +2198,12 @@ bool CodeGenFunction::EmitOMPWorksharingLoop(const OMPLoopDirective &S) {
                          },
                          [](CodeGenFunction &) {});
         EmitBlock(LoopExit.getBlock());
-        // Tell the runtime we are done.
-        auto &&CodeGen = [&S](CodeGenFunction &CGF) {
-          CGF.CGM.getOpenMPRuntime().emitForStaticFinish(CGF, S.getLocEnd());
+        // Tell the runtime we are done, unless it was not involved.
+        bool Inlined = RT.isStaticScheduleInlined(
+            ScheduleKind.Schedule, /*Chunked=*/false, Ordered);
+        auto &&CodeGen = [&S, Inlined](CodeGenFunction &CGF) {
+          if (!Inlined)
+            CGF.CGM.getOpenMPRuntime().emitForStaticFinish(CGF, S.getLocEnd());
         };
         OMPCancelStack.emitExit(*this, S.getDirectiveKind(), CodeGen);
       } else {
@@ -2392,9 +2395,12 @@ void CodeGenFunction::EmitSections(const OMPExecutableDirective &S) {
     // while (idx <= UB) { BODY; ++idx; }
     CGF.EmitOMPInnerLoop(S, /*RequiresCleanup=*/false, &Cond, &Inc, BodyGen,
                          [](CodeGenFunction &) {});
-    // Tell the runtime we are done.
-    auto &&CodeGen = [&S](CodeGenFunction &CGF) {
-      CGF.CGM.getOpenMPRuntime().emitForStaticFinish(CGF, S.getLocEnd());
+    // Tell the runtime we are done, unless it was not involved.
+    bool Inlined = CGF.CGM.getOpenMPRuntime().isStaticScheduleInlined(
+        ScheduleKind.Schedule, /*Chunked=*/false, /*Ordered=*/false);
+    auto &&CodeGen = [&S, Inlined](CodeGenFunction &CGF) {
+      if (!Inlined)
+        CGF.CGM.getOpenMPRuntime().emitForStaticFinish(CGF, S.getLocEnd());
     };
     CGF.OMPCancelStack.emitExit(CGF, S.getDirectiveKind(), CodeGen);
     CGF.EmitOMPReductionClauseFinal(S);
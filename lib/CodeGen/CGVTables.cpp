@@ -155,6 +155,21 @@ CodeGenFunction::GenerateVarArgsThunk(llvm::Function *Fn,
   // Clone to thunk.
   llvm::ValueToValueMapTy VMap;
   llvm::Function *NewFn = llvm::CloneFunction(BaseFn, VMap);
+
+  // The clone gets 'this' before it is adjusted, so take the attributes of
+  // the return value and parameters from the thunk rather than from the
+  // function it was cloned from.
+  if (CGM.getCodeGenOpts().StrictPointerAttributes) {
+    llvm::AttributeSet Attrs = Fn->getAttributes();
+    Attrs = Attrs.removeAttributes(getLLVMContext(),
+                                   llvm::AttributeSet::FunctionIndex,
+                                   Attrs.getFnAttributes());
+    Attrs = Attrs.addAttributes(getLLVMContext(),
+                                llvm::AttributeSet::FunctionIndex,
+                                NewFn->getAttributes().getFnAttributes());
+    NewFn->setAttributes(Attrs);
+  }
+
   Fn->replaceAllUsesWith(NewFn);
   NewFn->takeName(Fn);
   Fn->eraseFromParent();
@@ -379,7 +394,8 @@ void CodeGenFunction::EmitMustTailThunk(const CXXMethodDecl *MD,
   CodeGen::AttributeListType AttributeList;
   CGM.ConstructAttributeList(CalleePtr->getName(),
                              *CurFnInfo, MD, AttributeList,
-                             CallingConv, /*AttrOnCallSite=*/true);
+                             CallingConv, /*AttrOnCallSite=*/true,
+                             /*IsThunk=*/false);
   llvm::AttributeSet Attrs =
       llvm::AttributeSet::get(getLLVMContext(), AttributeList);
   Call->setAttributes(Attrs);
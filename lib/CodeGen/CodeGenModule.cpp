@@ -41,8 +41,10 @@
 #include "clang/Basic/Module.h"
 #include "clang/Basic/SourceManager.h"
 #include "clang/Basic/TargetInfo.h"
+#include "clang/Basic/TimeTrace.h"
 #include "clang/Basic/Version.h"
 #include "clang/Frontend/CodeGenOptions.h"
+#include "clang/Frontend/FrontendDiagnostic.h"
 #include "clang/Sema/SemaDiagnostic.h"
 #include "llvm/ADT/Triple.h"
 #include "llvm/IR/CallSite.h"
@@ -512,6 +514,46 @@ void CodeGenModule::RefreshTypeCacheForClass(const CXXRecordDecl *RD) {
   Types.RefreshTypeCacheForClass(RD);
 }
 
+CharUnits CodeGenModule::getNaturalTypeAlignment(QualType T,
+                                                 AlignmentSource *Source,
+                                                 bool forPointeeType) {
+  // Honor alignment typedef attributes even on incomplete types.
+  // We also honor them straight for C++ class types, even as pointees;
+  // there's an expressivity gap here.
+  if (auto TT = T->getAs<TypedefType>()) {
+    if (auto Align = TT->getDecl()->getMaxAlignment()) {
+      if (Source) *Source = AlignmentSource::AttributedType;
+      return getContext().toCharUnitsFromBits(Align);
+    }
+  }
+
+  if (Source) *Source = AlignmentSource::Type;
+
+  CharUnits Alignment;
+  if (T->isIncompleteType()) {
+    Alignment = CharUnits::One(); // Shouldn't be used, but pessimistic is best.
+  } else {
+    // For C++ class pointees, we don't know whether we're pointing at a
+    // base or a complete object, so we generally need to use the
+    // non-virtual alignment.
+    const CXXRecordDecl *RD;
+    if (forPointeeType && (RD = T->getAsCXXRecordDecl())) {
+      Alignment = getClassPointerAlignment(RD);
+    } else {
+      Alignment = getContext().getTypeAlignInChars(T);
+    }
+
+    // Cap to the global maximum type alignment unless the alignment
+    // was somehow explicit on the type.
+    if (unsigned MaxAlign = getLangOpts().MaxTypeAlign) {
+      if (Alignment.getQuantity() > MaxAlign &&
+          !getContext().isAlignmentRequired(T))
+        Alignment = CharUnits::fromQuantity(MaxAlign);
+    }
+  }
+  return Alignment;
+}
+
 llvm::MDNode *CodeGenModule::getTBAAInfo(QualType QTy) {
   if (!TBAA)
     return nullptr;
@@ -530,6 +572,19 @@ llvm::MDNode *CodeGenModule::getTBAAStructInfo(QualType QTy) {
   return TBAA->getTBAAStructInfo(QTy);
 }
 
+void CodeGenModule::remarkConservativeTBAA(SourceLocation Loc, QualType Ty,
+                                           llvm::MDNode *TBAAInfo,
+                                           bool IsStore) {
+  if (!TBAA || !TBAAInfo ||
+      getDiags().isIgnored(diag::remark_tbaa_conservative_access, Loc))
+    return;
+  CodeGenTBAA::ConservativeReason Reason =
+      TBAA->getConservativeReason(Ty, TBAAInfo);
+  if (Reason != CodeGenTBAA::CR_None)
+    getDiags().Report(Loc, diag::remark_tbaa_conservative_access)
+        << IsStore << Ty << Reason;
+}
+
 llvm::MDNode *CodeGenModule::getTBAAStructTagInfo(QualType BaseTy,
                                                   llvm::MDNode *AccessN,
                                                   uint64_t O) {
@@ -828,11 +883,12 @@ void CodeGenModule::setFunctionDefinitionAttributes(const FunctionDecl *D,
 
 void CodeGenModule::SetLLVMFunctionAttributes(const Decl *D,
                                               const CGFunctionInfo &Info,
-                                              llvm::Function *F) {
+                                              llvm::Function *F,
+                                              bool IsThunk) {
   unsigned CallingConv;
   AttributeListType AttributeList;
   ConstructAttributeList(F->getName(), Info, D, AttributeList, CallingConv,
-                         false);
+                         false, IsThunk);
   F->setAttributes(llvm::AttributeSet::get(getLLVMContext(), AttributeList));
   F->setCallingConv(static_cast<llvm::CallingConv::ID>(CallingConv));
 }
@@ -1009,7 +1065,7 @@ void CodeGenModule::setNonAliasAttributes(const Decl *D,
 void CodeGenModule::SetInternalFunctionAttributes(const Decl *D,
                                                   llvm::Function *F,
                                                   const CGFunctionInfo &FI) {
-  SetLLVMFunctionAttributes(D, FI, F);
+  SetLLVMFunctionAttributes(D, FI, F, /*IsThunk=*/false);
   SetLLVMFunctionAttributesForDefinition(D, F);
 
   F->setLinkage(llvm::Function::InternalLinkage);
@@ -1082,7 +1138,8 @@ void CodeGenModule::SetFunctionAttributes(GlobalDecl GD, llvm::Function *F,
   const auto *FD = cast<FunctionDecl>(GD.getDecl());
 
   if (!IsIncompleteFunction)
-    SetLLVMFunctionAttributes(FD, getTypes().arrangeGlobalDeclaration(GD), F);
+    SetLLVMFunctionAttributes(FD, getTypes().arrangeGlobalDeclaration(GD), F,
+                              IsThunk);
 
   // Add the Returned attribute for "this", except for iOS 5 and earlier
   // where substantial code, including the libstdc++ dylib, was compiled with
@@ -1850,7 +1907,16 @@ void CodeGenModule::EmitGlobalDefinition(GlobalDecl GD, llvm::GlobalValue *GV) {
   PrettyStackTraceDecl CrashInfo(const_cast<ValueDecl *>(D), D->getLocation(), 
                                  Context.getSourceManager(),
                                  "Generating code for declaration");
-  
+
+  TimeTraceScope TimeScope(
+      isa<FunctionDecl>(D) ? "CodeGen Function" : "CodeGen Variable", [&]() {
+        std::string Name;
+        llvm::raw_string_ostream OS(Name);
+        D->getNameForDiagnostic(OS, getContext().getPrintingPolicy(),
+                                /*Qualified=*/true);
+        return OS.str();
+      });
+
   if (isa<FunctionDecl>(D)) {
     // At -O0, don't generate IR for functions with available_externally 
     // linkage.
@@ -1870,11 +1936,15 @@ void CodeGenModule::EmitGlobalDefinition(GlobalDecl GD, llvm::GlobalValue *GV) {
 
       if (Method->isVirtual())
         getVTables().EmitThunks(GD);
-
-      return;
+    } else {
+      EmitGlobalFunctionDefinition(GD, GV);
     }
 
-    return EmitGlobalFunctionDefinition(GD, GV);
+    // Release the body if Sema allocated it in an arena of its own; nothing
+    // refers to it any more.
+    if (LangOpts.FreeFunctionBodies)
+      Context.releaseFunctionBody(cast<FunctionDecl>(D));
+    return;
   }
 
   if (const auto *VD = dyn_cast<VarDecl>(D))
@@ -93,6 +93,7 @@ class BlockFieldFlags;
 class FunctionArgList;
 class CoverageMappingModuleGen;
 class TargetCodeGenInfo;
+enum class AlignmentSource;
 
 enum ForDefinition_t : bool {
   NotForDefinition = false,
@@ -649,6 +650,12 @@ public:
   llvm::MDNode *getTBAAInfo(QualType QTy);
   llvm::MDNode *getTBAAInfoForVTablePtr();
   llvm::MDNode *getTBAAStructInfo(QualType QTy);
+
+  /// Emit a remark if an access of type \p Ty with the TBAA type
+  /// \p TBAAInfo may alias accesses of any type.
+  void remarkConservativeTBAA(SourceLocation Loc, QualType Ty,
+                              llvm::MDNode *TBAAInfo, bool IsStore);
+
   /// Return the path-aware tag for given base type, access node and offset.
   llvm::MDNode *getTBAAStructTagInfo(QualType BaseTy, llvm::MDNode *AccessN,
                                      uint64_t O);
@@ -747,6 +754,12 @@ public:
   /// Returns the assumed alignment of an opaque pointer to the given class.
   CharUnits getClassPointerAlignment(const CXXRecordDecl *CD);
 
+  /// Returns the natural alignment of an object of type \p T, or of the
+  /// object that a pointer to \p T points to if \p forPointeeType is set.
+  CharUnits getNaturalTypeAlignment(QualType T,
+                                    AlignmentSource *Source = nullptr,
+                                    bool forPointeeType = false);
+
   /// Returns the assumed alignment of a virtual base of a class.
   CharUnits getVBaseAlignment(CharUnits DerivedAlign,
                               const CXXRecordDecl *Derived,
@@ -989,7 +1002,7 @@ public:
   /// Set the LLVM function attributes (sext, zext, etc).
   void SetLLVMFunctionAttributes(const Decl *D,
                                  const CGFunctionInfo &Info,
-                                 llvm::Function *F);
+                                 llvm::Function *F, bool IsThunk);
 
   /// Set the LLVM function attributes which only apply to a function
   /// definition.
@@ -1018,9 +1031,12 @@ public:
   /// contribute to the function attributes and calling convention.
   /// \param PAL [out] - On return, the attribute list to use.
   /// \param CallingConv [out] - On return, the LLVM calling convention to use.
+  /// \param IsThunk - Whether the attributes are for a thunk, which receives
+  /// 'this' before it is adjusted.
   void ConstructAttributeList(StringRef Name, const CGFunctionInfo &Info,
                               CGCalleeInfo CalleeInfo, AttributeListType &PAL,
-                              unsigned &CallingConv, bool AttrOnCallSite);
+                              unsigned &CallingConv, bool AttrOnCallSite,
+                              bool IsThunk);
 
   // Fills in the supplied string map with the set of target features for the
   // passed in function.
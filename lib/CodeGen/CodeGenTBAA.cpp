@@ -146,6 +146,26 @@ CodeGenTBAA::getTBAAInfo(QualType QTy) {
     return MetadataCache[Ty] = createTBAAScalarType("any pointer",
                                                     getChar());
 
+  // Vector types alias their element types. Unless -fstrict-vector-aliasing
+  // is given, they are treated like char instead, since the target intrinsic
+  // vector types are commonly used to access memory of any type.
+  if (const VectorType *VTy = dyn_cast<VectorType>(Ty)) {
+    llvm::MDNode *N = CodeGenOpts.StrictVectorAliasing
+                          ? getTBAAInfo(VTy->getElementType())
+                          : getChar();
+    return MetadataCache[Ty] = N;
+  }
+
+  // A union whose members all have the same type for TBAA purposes is
+  // accessed as that type.
+  if (const RecordType *RTy = dyn_cast<RecordType>(Ty)) {
+    const RecordDecl *RD = RTy->getDecl()->getDefinition();
+    if (RD && RD->isUnion()) {
+      llvm::MDNode *N = getUnionMemberTBAAInfo(RD);
+      return MetadataCache[Ty] = N;
+    }
+  }
+
   // Enum types are distinct types. In C++ they have "underlying types",
   // however they aren't related for TBAA.
   if (const EnumType *ETy = dyn_cast<EnumType>(Ty)) {
@@ -166,6 +186,49 @@ CodeGenTBAA::getTBAAInfo(QualType QTy) {
   return MetadataCache[Ty] = getChar();
 }
 
+llvm::MDNode *CodeGenTBAA::getUnionMemberTBAAInfo(const RecordDecl *RD) {
+  llvm::MDNode *Common = nullptr;
+  for (const FieldDecl *FD : RD->fields()) {
+    // Arrays are accessed through their elements.
+    QualType FieldQTy = FD->getType();
+    llvm::MDNode *N = TypeHasMayAlias(FieldQTy)
+                          ? getChar()
+                          : getTBAAInfo(Context.getBaseElementType(FieldQTy));
+    if (Common && N != Common)
+      return getChar();
+    Common = N;
+  }
+  return Common ? Common : getChar();
+}
+
+CodeGenTBAA::ConservativeReason
+CodeGenTBAA::getConservativeReason(QualType QTy, llvm::MDNode *AccessNode) {
+  if (AccessNode != getChar())
+    return CR_None;
+
+  if (TypeHasMayAlias(QTy))
+    return CR_MayAliasType;
+
+  const Type *Ty = Context.getCanonicalType(QTy).getTypePtr();
+  if (Ty->isCharType())
+    return CR_None;
+  if (const VectorType *VTy = dyn_cast<VectorType>(Ty)) {
+    if (!CodeGenOpts.StrictVectorAliasing)
+      return CR_Vector;
+    QualType EltTy = VTy->getElementType();
+    return EltTy->isCharType() ? CR_None
+                               : getConservativeReason(EltTy, AccessNode);
+  }
+  if (Ty->isEnumeralType())
+    return CR_Enum;
+
+  // Any other type with a TBAA type of its own was made to alias everything
+  // by its context.
+  if (isa<BuiltinType>(Ty) || Ty->isPointerType())
+    return CR_MayAliasRecord;
+  return CR_Other;
+}
+
 llvm::MDNode *CodeGenTBAA::getTBAAInfoForVTablePtr() {
   return createTBAAScalarType("vtable pointer", getRoot());
 }
@@ -83,6 +83,10 @@ class CodeGenTBAA {
                      SmallVectorImpl<llvm::MDBuilder::TBAAStructField> &Fields,
                      bool MayAlias);
 
+  /// Get the TBAA type of the members of the union \p RD if they all have
+  /// the same one, or the char type otherwise.
+  llvm::MDNode *getUnionMemberTBAAInfo(const RecordDecl *RD);
+
   /// A wrapper function to create a scalar type. For struct-path aware TBAA,
   /// the scalar type has the same format as the struct type: name, offset,
   /// pointer to another node in the type DAG.
@@ -99,6 +103,23 @@ public:
   /// of the given type.
   llvm::MDNode *getTBAAInfo(QualType QTy);
 
+  /// The reasons for which an access is given the char type, in the order
+  /// of the remark_tbaa_conservative_access diagnostic.
+  enum ConservativeReason {
+    CR_MayAliasType,
+    CR_MayAliasRecord,
+    CR_Vector,
+    CR_Enum,
+    CR_Other,
+    CR_None
+  };
+
+  /// Determine why an access of type \p QTy using the TBAA type
+  /// \p AccessNode may alias any other access. Returns CR_None if it doesn't,
+  /// or if it has a character type.
+  ConservativeReason getConservativeReason(QualType QTy,
+                                           llvm::MDNode *AccessNode);
+
   /// getTBAAInfoForVTablePtr - Get the TBAA MDNode to be used for a
   /// dereference of a vtable pointer.
   llvm::MDNode *getTBAAInfoForVTablePtr();
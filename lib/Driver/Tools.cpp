@@ -5324,6 +5324,12 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
   if (Args.hasFlag(options::OPT_fstrict_enums, options::OPT_fno_strict_enums,
                    false))
     CmdArgs.push_back("-fstrict-enums");
+  if (Args.hasFlag(options::OPT_fstrict_pointer_attributes,
+                   options::OPT_fno_strict_pointer_attributes, false))
+    CmdArgs.push_back("-fstrict-pointer-attributes");
+  if (Args.hasFlag(options::OPT_fstrict_vector_aliasing,
+                   options::OPT_fno_strict_vector_aliasing, false))
+    CmdArgs.push_back("-fstrict-vector-aliasing");
   if (!Args.hasFlag(options::OPT_fstrict_return, options::OPT_fno_strict_return,
                     true))
     CmdArgs.push_back("-fno-strict-return");
@@ -5799,6 +5805,13 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
   RenderDebugEnablingArgs(Args, CmdArgs, DebugInfoKind, DwarfVersion,
                           DebuggerTuning);
 
+  // Constructor homing only further limits the types that -fno-standalone-debug
+  // emits, so it has no effect with other debug info kinds.
+  if (Args.hasFlag(options::OPT_fuse_ctor_homing,
+                   options::OPT_fno_use_ctor_homing, false) &&
+      DebugInfoKind == codegenoptions::LimitedDebugInfo)
+    CmdArgs.push_back("-fuse-ctor-homing");
+
   // -ggnu-pubnames turns on gnu style pubnames in the backend.
   if (Args.hasArg(options::OPT_ggnu_pubnames)) {
     CmdArgs.push_back("-backend-option");
@@ -6237,6 +6250,14 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
       if (!Args.hasFlag(options::OPT_fopenmp_use_tls,
                         options::OPT_fnoopenmp_use_tls, /*Default=*/true))
         CmdArgs.push_back("-fnoopenmp-use-tls");
+      if (Args.hasFlag(options::OPT_fopenmp_inline_static_schedule,
+                       options::OPT_fno_openmp_inline_static_schedule,
+                       /*Default=*/false))
+        CmdArgs.push_back("-fopenmp-inline-static-schedule");
+      if (Args.hasFlag(options::OPT_fopenmp_instrument_offload,
+                       options::OPT_fno_openmp_instrument_offload,
+                       /*Default=*/false))
+        CmdArgs.push_back("-fopenmp-instrument-offload");
       Args.AddAllArgs(CmdArgs, options::OPT_fopenmp_version_EQ);
       break;
     default:
@@ -7300,8 +7321,38 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
       !C.getDriver().embedBitcodeInObject() && isa<CompileJobAction>(JA))
     CmdArgs.push_back("-disable-llvm-passes");
 
+  // With -fsplit-codegen=N, the code generator writes N partitions of the
+  // object file in parallel, which are combined by a relocatable link.
+  SmallVector<const char *, 8> SplitCodeGenParts;
+  if (Arg *A = Args.getLastArg(options::OPT_fsplit_codegen_EQ)) {
+    unsigned NumParts;
+    if (StringRef(A->getValue()).getAsInteger(10, NumParts) || NumParts == 0)
+      D.Diag(diag::err_drv_invalid_int_value)
+          << A->getAsString(Args) << A->getValue();
+    else if (!getToolChain().getTriple().isOSBinFormatELF() &&
+             !getToolChain().getTriple().isOSBinFormatMachO())
+      D.Diag(diag::err_drv_unsupported_opt_for_target)
+          << A->getAsString(Args) << getToolChain().getTriple().str();
+    else if (NumParts > 1 && Output.getType() == types::TY_Object) {
+      StringRef Stem = llvm::sys::path::stem(Output.getFilename());
+      for (unsigned I = 0; I != NumParts; ++I) {
+        std::string Part = D.GetTemporaryPath(
+            (Stem + "-part" + Twine(I)).str(), "o");
+        SplitCodeGenParts.push_back(
+            C.addTempFile(Args.MakeArgString(Part)));
+      }
+    }
+  }
+
   if (Output.getType() == types::TY_Dependencies) {
     // Handled with other dependency code.
+  } else if (!SplitCodeGenParts.empty()) {
+    CmdArgs.push_back("-o");
+    CmdArgs.push_back(SplitCodeGenParts.front());
+    for (const char *Part : makeArrayRef(SplitCodeGenParts).drop_front()) {
+      CmdArgs.push_back("-split-codegen-output");
+      CmdArgs.push_back(Part);
+    }
   } else if (Output.isFilename()) {
     CmdArgs.push_back("-o");
     CmdArgs.push_back(Output.getFilename());
@@ -7351,6 +7402,20 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
     CmdArgs.push_back(SplitDwarfOut);
   }
 
+  // Each partition of the object file gets a split debug info file of its
+  // own, named after the one of the object file.
+  SmallVector<const char *, 8> SplitCodeGenDwarfFiles;
+  if (SplitDwarf && !SplitCodeGenParts.empty()) {
+    SplitCodeGenDwarfFiles.push_back(SplitDwarfOut);
+    for (unsigned I = 1, E = SplitCodeGenParts.size(); I != E; ++I) {
+      SmallString<128> T(SplitDwarfOut);
+      llvm::sys::path::replace_extension(T, "part" + Twine(I) + ".dwo");
+      SplitCodeGenDwarfFiles.push_back(Args.MakeArgString(T));
+      CmdArgs.push_back("-split-codegen-dwarf-file");
+      CmdArgs.push_back(SplitCodeGenDwarfFiles.back());
+    }
+  }
+
   // Host-side cuda compilation receives device-side outputs as Inputs[1...].
   // Include them with -fcuda-include-gpubinary.
   if (IsCuda && Inputs.size() > 1)
@@ -7418,10 +7483,31 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
     C.addCommand(llvm::make_unique<Command>(JA, *this, Exec, CmdArgs, Inputs));
   }
 
+  // Combine the partitions of the object file, after moving the debug info
+  // of each of them to its split debug info file.
+  if (!SplitCodeGenParts.empty()) {
+    for (unsigned I = 0, E = SplitCodeGenDwarfFiles.size(); I != E; ++I)
+      SplitDebugInfo(getToolChain(), C, *this, JA, Args,
+                     InputInfo(types::TY_Object, SplitCodeGenParts[I],
+                               SplitCodeGenParts[I]),
+                     SplitCodeGenDwarfFiles[I]);
+
+    ArgStringList LinkArgs;
+    LinkArgs.push_back("-r");
+    LinkArgs.push_back("-o");
+    LinkArgs.push_back(Output.getFilename());
+    LinkArgs.append(SplitCodeGenParts.begin(), SplitCodeGenParts.end());
+
+    const char *Linker = Args.MakeArgString(getToolChain().GetLinkerPath());
+    InputInfo II(types::TY_Object, Output.getFilename(), Output.getFilename());
+    C.addCommand(llvm::make_unique<Command>(JA, *this, Linker, LinkArgs, II));
+  }
+
   // Handle the debug info splitting at object creation time if we're
   // creating an object.
   // TODO: Currently only works on linux with newer objcopy.
-  if (SplitDwarf && Output.getType() == types::TY_Object)
+  if (SplitDwarf && Output.getType() == types::TY_Object &&
+      SplitCodeGenParts.empty())
     SplitDebugInfo(getToolChain(), C, *this, JA, Args, Output, SplitDwarfOut);
 
   if (Arg *A = Args.getLastArg(options::OPT_pg))
@@ -0,0 +1,314 @@
+//===--- ASTMemoryStats.cpp - Breakdown of AST memory usage ---------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements PrintASTMemoryStats, which attributes the memory used
+// by the AST to node kinds, source files and the origin of the nodes, and
+// writes the result as JSON.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Frontend/Utils.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/DeclCXX.h"
+#include "clang/AST/DeclFriend.h"
+#include "clang/AST/DeclObjC.h"
+#include "clang/AST/DeclOpenMP.h"
+#include "clang/AST/DeclTemplate.h"
+#include "clang/AST/ExprCXX.h"
+#include "clang/AST/ExprObjC.h"
+#include "clang/AST/ExprOpenMP.h"
+#include "clang/AST/RecursiveASTVisitor.h"
+#include "clang/AST/StmtCXX.h"
+#include "clang/AST/StmtObjC.h"
+#include "clang/AST/StmtOpenMP.h"
+#include "clang/Basic/SourceManager.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <vector>
+
+using namespace clang;
+
+namespace {
+
+/// \brief Where a node came from.
+enum NodeOrigin {
+  /// \brief Written in the source.
+  NO_Parsed,
+  /// \brief Instantiated from a template.
+  NO_Instantiated,
+  /// \brief Created implicitly by Sema, such as implicit special members.
+  NO_Implicit,
+  /// \brief Loaded from a PCH or module file.
+  NO_Deserialized,
+  NO_NumOrigins
+};
+
+const char *const OriginNames[NO_NumOrigins] = {
+  "parsed", "instantiated", "implicit", "deserialized"
+};
+
+/// \brief The number and estimated size of a set of nodes.
+struct NodeUsage {
+  uint64_t Count = 0;
+  uint64_t Bytes = 0;
+
+  void add(uint64_t Size) {
+    ++Count;
+    Bytes += Size;
+  }
+};
+
+struct FileUsage {
+  NodeUsage Origins[NO_NumOrigins];
+};
+
+/// \brief Walks the AST and attributes each declaration and statement to its
+/// kind, to the file of the enclosing declaration, and to its origin.
+class ASTMemoryStatsCollector
+    : public RecursiveASTVisitor<ASTMemoryStatsCollector> {
+  typedef RecursiveASTVisitor<ASTMemoryStatsCollector> Base;
+
+  const SourceManager &SM;
+
+  /// \brief The file and origin of the innermost declaration being walked.
+  FileUsage *CurrentFile = nullptr;
+  NodeOrigin CurrentOrigin = NO_Parsed;
+
+  /// \brief The file usage for each FileID seen so far, to avoid looking up
+  /// the file name for every declaration.
+  llvm::DenseMap<FileID, FileUsage *> FileUsageForID;
+
+public:
+  llvm::StringMap<NodeUsage> DeclKinds;
+  llvm::StringMap<NodeUsage> StmtKinds;
+  llvm::StringMap<FileUsage> Files;
+  NodeUsage Origins[NO_NumOrigins];
+
+  explicit ASTMemoryStatsCollector(const SourceManager &SM) : SM(SM) {}
+
+  bool shouldVisitTemplateInstantiations() const { return true; }
+  bool shouldVisitImplicitCode() const { return true; }
+
+  FileUsage *getFileUsage(SourceLocation Loc) {
+    FileID FID;
+    if (Loc.isValid())
+      FID = SM.getFileID(SM.getExpansionLoc(Loc));
+
+    FileUsage *&Usage = FileUsageForID[FID];
+    if (!Usage) {
+      StringRef Name = "<none>";
+      if (const FileEntry *FE = SM.getFileEntryForID(FID))
+        Name = FE->getName();
+      else if (FID.isValid())
+        Name = SM.getBuffer(FID)->getBufferIdentifier();
+      Usage = &Files[Name];
+    }
+    return Usage;
+  }
+
+  static NodeOrigin getOrigin(const Decl *D, NodeOrigin ParentOrigin) {
+    if (D->isFromASTFile())
+      return NO_Deserialized;
+    if (ParentOrigin == NO_Instantiated || ParentOrigin == NO_Deserialized)
+      return ParentOrigin;
+
+    TemplateSpecializationKind TSK = TSK_Undeclared;
+    if (const auto *FD = dyn_cast<FunctionDecl>(D))
+      TSK = FD->getTemplateSpecializationKind();
+    else if (const auto *RD = dyn_cast<CXXRecordDecl>(D))
+      TSK = RD->getTemplateSpecializationKind();
+    else if (const auto *VD = dyn_cast<VarDecl>(D))
+      TSK = VD->getTemplateSpecializationKind();
+    else if (const auto *ED = dyn_cast<EnumDecl>(D))
+      TSK = ED->getTemplateSpecializationKind();
+    if (isTemplateInstantiation(TSK))
+      return NO_Instantiated;
+
+    if (D->isImplicit() || ParentOrigin == NO_Implicit)
+      return NO_Implicit;
+    return NO_Parsed;
+  }
+
+  static uint64_t getDeclSize(Decl::Kind K) {
+    switch (K) {
+#define DECL(DERIVED, BASE)                                                    \
+    case Decl::DERIVED:                                                        \
+      return sizeof(DERIVED##Decl);
+#define ABSTRACT_DECL(DECL)
+#include "clang/AST/DeclNodes.inc"
+    }
+    llvm_unreachable("unknown declaration kind");
+  }
+
+  static uint64_t getStmtSize(Stmt::StmtClass SC) {
+    switch (SC) {
+    case Stmt::NoStmtClass:
+      break;
+#define STMT(CLASS, PARENT)                                                    \
+    case Stmt::CLASS##Class:                                                   \
+      return sizeof(CLASS);
+#define ABSTRACT_STMT(STMT)
+#include "clang/AST/StmtNodes.inc"
+    }
+    llvm_unreachable("unknown statement class");
+  }
+
+  void account(NodeUsage &Kind, uint64_t Size) {
+    Kind.add(Size);
+    CurrentFile->Origins[CurrentOrigin].add(Size);
+    Origins[CurrentOrigin].add(Size);
+  }
+
+  bool TraverseDecl(Decl *D) {
+    if (!D)
+      return true;
+
+    FileUsage *SavedFile = CurrentFile;
+    NodeOrigin SavedOrigin = CurrentOrigin;
+    CurrentFile = getFileUsage(D->getLocation());
+    CurrentOrigin = getOrigin(D, CurrentOrigin);
+    account(DeclKinds[D->getDeclKindName()], getDeclSize(D->getKind()));
+
+    // Don't walk into declarations from AST files; that would deserialize
+    // them and change the memory usage that is being measured.
+    bool Result = D->isFromASTFile() || Base::TraverseDecl(D);
+
+    CurrentFile = SavedFile;
+    CurrentOrigin = SavedOrigin;
+    return Result;
+  }
+
+  bool TraverseTranslationUnitDecl(TranslationUnitDecl *TU) {
+    for (Decl *D : TU->noload_decls())
+      if (!TraverseDecl(D))
+        return false;
+    return true;
+  }
+
+  bool VisitStmt(Stmt *S) {
+    if (!CurrentFile)
+      CurrentFile = getFileUsage(S->getLocStart());
+    account(StmtKinds[S->getStmtClassName()], getStmtSize(S->getStmtClass()));
+    return true;
+  }
+};
+
+} // end anonymous namespace
+
+static uint64_t getTypeSize(const Type *T) {
+  switch (T->getTypeClass()) {
+#define TYPE(CLASS, BASE)                                                      \
+  case Type::CLASS:                                                            \
+    return sizeof(CLASS##Type);
+#define ABSTRACT_TYPE(CLASS, BASE)
+#include "clang/AST/TypeNodes.def"
+  }
+  llvm_unreachable("unknown type class");
+}
+
+/// \brief Write \p Str as a JSON string literal.
+static void writeJSONString(raw_ostream &OS, StringRef Str) {
+  OS << '"';
+  for (unsigned char C : Str) {
+    if (C == '"' || C == '\\')
+      OS << '\\' << C;
+    else if (C < 0x20)
+      OS << llvm::format("\\u%04x", C);
+    else
+      OS << C;
+  }
+  OS << '"';
+}
+
+static void writeUsage(raw_ostream &OS, const NodeUsage &Usage) {
+  OS << "{\"count\": " << Usage.Count << ", \"bytes\": " << Usage.Bytes << '}';
+}
+
+/// \brief Write the entries of \p Map as a JSON object, from the largest to
+/// the smallest.
+template <typename T, typename SizeFn, typename WriteFn>
+static void writeSortedMap(raw_ostream &OS, const llvm::StringMap<T> &Map,
+                           SizeFn Size, WriteFn Write) {
+  std::vector<const llvm::StringMapEntry<T> *> Entries;
+  for (const auto &Entry : Map)
+    Entries.push_back(&Entry);
+  std::sort(Entries.begin(), Entries.end(),
+            [&](const llvm::StringMapEntry<T> *A,
+                const llvm::StringMapEntry<T> *B) {
+              uint64_t SizeA = Size(A->getValue());
+              uint64_t SizeB = Size(B->getValue());
+              if (SizeA != SizeB)
+                return SizeA > SizeB;
+              return A->getKey() < B->getKey();
+            });
+
+  OS << '{';
+  for (unsigned I = 0, N = Entries.size(); I != N; ++I) {
+    OS << (I ? ",\n    " : "\n    ");
+    writeJSONString(OS, Entries[I]->getKey());
+    OS << ": ";
+    Write(Entries[I]->getValue());
+  }
+  OS << (Entries.empty() ? "}" : "\n  }");
+}
+
+void clang::PrintASTMemoryStats(ASTContext &Context, raw_ostream &OS) {
+  ASTMemoryStatsCollector Collector(Context.getSourceManager());
+  Collector.TraverseDecl(Context.getTranslationUnitDecl());
+
+  llvm::StringMap<NodeUsage> TypeKinds;
+  for (const Type *T : Context.getTypes())
+    TypeKinds[T->getTypeClassName()].add(getTypeSize(T));
+
+  auto UsageBytes = [](const NodeUsage &U) { return U.Bytes; };
+  auto WriteUsage = [&](const NodeUsage &U) { writeUsage(OS, U); };
+
+  // The node sizes are those of the node classes; trailing storage such as
+  // the parameters of a function type or the arguments of a call is counted
+  // by the allocator totals only.
+  OS << "{\n";
+  OS << "  \"allocator\": {\"bytes_reserved\": "
+     << Context.getASTAllocatedMemory()
+     << ", \"bytes_allocated\": " << Context.getAllocator().getBytesAllocated()
+     << ", \"side_table_bytes\": " << Context.getSideTableAllocatedMemory()
+     << "},\n";
+
+  OS << "  \"decls\": ";
+  writeSortedMap(OS, Collector.DeclKinds, UsageBytes, WriteUsage);
+  OS << ",\n  \"stmts\": ";
+  writeSortedMap(OS, Collector.StmtKinds, UsageBytes, WriteUsage);
+  OS << ",\n  \"types\": ";
+  writeSortedMap(OS, TypeKinds, UsageBytes, WriteUsage);
+
+  OS << ",\n  \"origins\": {";
+  for (unsigned I = 0; I != NO_NumOrigins; ++I) {
+    OS << (I ? ", " : "") << '"' << OriginNames[I] << "\": ";
+    writeUsage(OS, Collector.Origins[I]);
+  }
+  OS << "},\n";
+
+  OS << "  \"files\": ";
+  writeSortedMap(OS, Collector.Files,
+                 [](const FileUsage &F) {
+                   uint64_t Bytes = 0;
+                   for (const NodeUsage &U : F.Origins)
+                     Bytes += U.Bytes;
+                   return Bytes;
+                 },
+                 [&](const FileUsage &F) {
+                   OS << '{';
+                   for (unsigned I = 0; I != NO_NumOrigins; ++I)
+                     OS << (I ? ", " : "") << '"' << OriginNames[I]
+                        << "\": " << F.Origins[I].Bytes;
+                   OS << '}';
+                 });
+  OS << "\n}\n";
+}
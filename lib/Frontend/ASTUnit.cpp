@@ -41,11 +41,13 @@
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Mutex.h"
 #include "llvm/Support/MutexGuard.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
 #include <atomic>
 #include <cstdio>
 #include <cstdlib>
+#include <sys/stat.h>
 
 using namespace clang;
 
@@ -79,9 +81,52 @@ namespace {
     }
   };
   
-  struct OnDiskData {
+  /// \brief A precompiled preamble together with everything an ASTUnit needs
+  /// to adopt it without building it again.
+  ///
+  /// Preambles are keyed on their contents, the options that affect how they
+  /// are parsed and the path of the main file, and are shared by all of the
+  /// ASTUnits in the process that compute the same key.
+  struct SharedPreamble {
     /// \brief The file in which the precompiled preamble is stored.
-    std::string PreambleFile;
+    std::string PCHFile;
+
+    /// \brief Whether \c PCHFile is a temporary file to be removed once the
+    /// last ASTUnit stops using it.
+    bool OwnsPCHFile;
+
+    /// \brief The files the preamble depends on, used to verify that the
+    /// preamble is still up to date before it is shared.
+    llvm::StringMap<ASTUnit::PreambleFileHash> FilesInPreamble;
+
+    /// \brief The serialization IDs of the top-level declarations in the
+    /// preamble.
+    std::vector<serialization::DeclID> TopLevelDecls;
+
+    /// \brief The diagnostics produced when building the preamble.
+    SmallVector<ASTUnit::StandaloneDiagnostic, 4> Diagnostics;
+
+    /// \brief The number of warnings produced when building the preamble.
+    unsigned NumWarnings;
+
+    /// \brief The hash of the top-level declaration and macro names in the
+    /// preamble.
+    unsigned TopLevelHashValue;
+
+    SharedPreamble(StringRef PCHFile, bool OwnsPCHFile)
+        : PCHFile(PCHFile), OwnsPCHFile(OwnsPCHFile), NumWarnings(0),
+          TopLevelHashValue(0) {}
+
+    ~SharedPreamble() {
+      if (OwnsPCHFile)
+        llvm::sys::fs::remove(PCHFile);
+    }
+  };
+
+  struct OnDiskData {
+    /// \brief The precompiled preamble in use, which may be shared with other
+    /// ASTUnits.
+    std::shared_ptr<SharedPreamble> Preamble;
 
     /// \brief Temporary files that should be removed when the ASTUnit is
     /// destroyed.
@@ -90,7 +135,8 @@ namespace {
     /// \brief Erase temporary files.
     void CleanTemporaryFiles();
 
-    /// \brief Erase the preamble file.
+    /// \brief Release the preamble file, erasing it if no other ASTUnit uses
+    /// it.
     void CleanPreambleFile();
 
     /// \brief Erase temporary files and the preamble file.
@@ -154,12 +200,24 @@ static void removeOnDiskEntry(const ASTUnit *AU) {
   }
 }
 
-static void setPreambleFile(const ASTUnit *AU, StringRef preambleFile) {
-  getOnDiskData(AU).PreambleFile = preambleFile;
+static void setSharedPreamble(const ASTUnit *AU,
+                              std::shared_ptr<SharedPreamble> Preamble) {
+  getOnDiskData(AU).Preamble = std::move(Preamble);
 }
 
 static const std::string &getPreambleFile(const ASTUnit *AU) {
-  return getOnDiskData(AU).PreambleFile;  
+  static const std::string NoPreambleFile;
+  const OnDiskData &D = getOnDiskData(AU);
+  return D.Preamble ? D.Preamble->PCHFile : NoPreambleFile;
+}
+
+typedef llvm::StringMap<std::weak_ptr<SharedPreamble>> SharedPreambleMap;
+
+/// \brief The preambles currently in use by some ASTUnit in this process,
+/// keyed by \c getPreambleCacheKey. Guarded by the on-disk mutex.
+static SharedPreambleMap &getSharedPreambleMap() {
+  static SharedPreambleMap M;
+  return M;
 }
 
 void OnDiskData::CleanTemporaryFiles() {
@@ -169,10 +227,7 @@ void OnDiskData::CleanTemporaryFiles() {
 }
 
 void OnDiskData::CleanPreambleFile() {
-  if (!PreambleFile.empty()) {
-    llvm::sys::fs::remove(PreambleFile);
-    PreambleFile.clear();
-  }
+  Preamble.reset();
 }
 
 void OnDiskData::Cleanup() {
@@ -185,7 +240,7 @@ struct ASTUnit::ASTWriterData {
   llvm::BitstreamWriter Stream;
   ASTWriter Writer;
 
-  ASTWriterData() : Stream(Buffer), Writer(Stream, { }) { }
+  ASTWriterData() : Stream(Buffer), Writer(Stream, Buffer, { }) { }
 };
 
 void ASTUnit::clearFileLevelDecls() {
@@ -1315,6 +1370,330 @@ makeStandaloneDiagnostic(const LangOptions &LangOpts,
   return OutDiag;
 }
 
+/// \brief Determine whether any of the files that a precompiled preamble was
+/// built from have changed since, taking the remappings in
+/// \p PreprocessorOpts into account.
+static bool anyPreambleFileChanged(
+    FileManager &FileMgr, const PreprocessorOptions &PreprocessorOpts,
+    const llvm::StringMap<ASTUnit::PreambleFileHash> &FilesInPreamble) {
+  bool AnyFileChanged = false;
+
+  // First, make a record of those files that have been overridden via
+  // remapping or unsaved_files.
+  std::map<llvm::sys::fs::UniqueID, ASTUnit::PreambleFileHash>
+      OverriddenFiles;
+  for (const auto &R : PreprocessorOpts.RemappedFiles) {
+    if (AnyFileChanged)
+      break;
+
+    vfs::Status Status;
+    if (FileMgr.getNoncachedStatValue(R.second, Status)) {
+      // If we can't stat the file we're remapping to, assume that something
+      // horrible happened.
+      AnyFileChanged = true;
+      break;
+    }
+
+    OverriddenFiles[Status.getUniqueID()] =
+        ASTUnit::PreambleFileHash::createForFile(
+            Status.getSize(),
+            llvm::sys::toTimeT(Status.getLastModificationTime()));
+  }
+
+  for (const auto &RB : PreprocessorOpts.RemappedFileBuffers) {
+    if (AnyFileChanged)
+      break;
+
+    vfs::Status Status;
+    if (FileMgr.getNoncachedStatValue(RB.first, Status)) {
+      AnyFileChanged = true;
+      break;
+    }
+
+    OverriddenFiles[Status.getUniqueID()] =
+        ASTUnit::PreambleFileHash::createForMemoryBuffer(RB.second);
+  }
+
+  // Check whether anything has changed.
+  for (llvm::StringMap<ASTUnit::PreambleFileHash>::const_iterator
+         F = FilesInPreamble.begin(), FEnd = FilesInPreamble.end();
+       !AnyFileChanged && F != FEnd;
+       ++F) {
+    vfs::Status Status;
+    if (FileMgr.getNoncachedStatValue(F->first(), Status)) {
+      // If we can't stat the file, assume that something horrible happened.
+      AnyFileChanged = true;
+      break;
+    }
+
+    auto Overridden = OverriddenFiles.find(Status.getUniqueID());
+    if (Overridden != OverriddenFiles.end()) {
+      // This file was remapped; check whether the newly-mapped file
+      // matches up with the previous mapping.
+      if (Overridden->second != F->second)
+        AnyFileChanged = true;
+      continue;
+    }
+
+    // The file was not remapped; check whether it has changed on disk.
+    if (Status.getSize() != uint64_t(F->second.Size) ||
+        llvm::sys::toTimeT(Status.getLastModificationTime()) !=
+            F->second.ModTime)
+      AnyFileChanged = true;
+  }
+
+  return AnyFileChanged;
+}
+
+/// \brief Compute the key under which a precompiled preamble with the given
+/// contents is shared between ASTUnits and processes.
+///
+/// The key covers everything that can change the meaning of the preamble
+/// other than the contents of the files it includes, which are checked
+/// separately against \c SharedPreamble::FilesInPreamble. It includes the
+/// path of the main file, because source locations within the preamble refer
+/// to the file it was built for.
+static std::string getPreambleCacheKey(const CompilerInvocation &Invocation,
+                                       StringRef MainFilePath,
+                                       StringRef PreambleBytes,
+                                       bool PreambleEndsAtStartOfLine) {
+  llvm::MD5 Hash;
+  auto AddString = [&Hash](StringRef Str) {
+    Hash.update(Str);
+    Hash.update(StringRef("", 1));
+  };
+
+  AddString(Invocation.getModuleHash());
+  const HeaderSearchOptions &HSOpts = Invocation.getHeaderSearchOpts();
+  for (const auto &Entry : HSOpts.UserEntries) {
+    AddString(Entry.Path);
+    AddString(Twine(unsigned(Entry.Group)).str());
+    AddString(Entry.IsFramework ? "f" : "");
+  }
+  const PreprocessorOptions &PPOpts = Invocation.getPreprocessorOpts();
+  for (const auto &Include : PPOpts.Includes)
+    AddString(Include);
+  for (const auto &Include : PPOpts.MacroIncludes)
+    AddString(Include);
+  AddString(PPOpts.ImplicitPCHInclude);
+  for (const auto &Warning : Invocation.getDiagnosticOpts().Warnings)
+    AddString(Warning);
+
+  AddString(MainFilePath);
+  AddString(PreambleEndsAtStartOfLine ? "1" : "0");
+  Hash.update(PreambleBytes);
+
+  llvm::MD5::MD5Result Result;
+  Hash.final(Result);
+  SmallString<32> Key;
+  llvm::MD5::stringifyResult(Result, Key);
+  return Key.str();
+}
+
+static std::shared_ptr<SharedPreamble> findSharedPreamble(StringRef Key) {
+  llvm::MutexGuard Guard(getOnDiskMutex());
+  SharedPreambleMap &M = getSharedPreambleMap();
+  auto Known = M.find(Key);
+  if (Known == M.end())
+    return nullptr;
+  return Known->second.lock();
+}
+
+static void registerSharedPreamble(StringRef Key,
+                                   const std::shared_ptr<SharedPreamble> &P) {
+  llvm::MutexGuard Guard(getOnDiskMutex());
+  SharedPreambleMap &M = getSharedPreambleMap();
+
+  // Drop the entries for preambles that are no longer used by anyone.
+  for (auto I = M.begin(), E = M.end(); I != E;) {
+    auto Current = I++;
+    if (Current->second.expired())
+      M.erase(Current);
+  }
+
+  M[Key] = P;
+}
+
+/// \brief Retrieve the directory in which precompiled preambles are stored
+/// for use by other processes, or an empty string if they should not be.
+static StringRef getPersistentPreambleDirectory() {
+  const char *Dir = ::getenv("LIBCLANG_PREAMBLE_CACHE_PATH");
+  return Dir ? Dir : "";
+}
+
+static void getPersistentPreamblePaths(StringRef Dir, StringRef Key,
+                                       SmallVectorImpl<char> &PCHPath,
+                                       SmallVectorImpl<char> &InfoPath) {
+  PCHPath.assign(Dir.begin(), Dir.end());
+  llvm::sys::path::append(PCHPath, Key + ".pch");
+  InfoPath.assign(Dir.begin(), Dir.end());
+  llvm::sys::path::append(InfoPath, Key + ".preamble");
+}
+
+/// \brief Remove the preambles in the persistent preamble directory \p Dir
+/// that have not been used for a while.
+///
+/// Like the module cache, the directory is only walked once per pruning
+/// interval, which is tracked through a timestamp file in the directory.
+static void prunePersistentPreambles(StringRef Dir) {
+  // Prune once a week, removing preambles that were unused for a month.
+  const time_t PruneInterval = 7 * 24 * 60 * 60;
+  const time_t PruneAfter = 31 * 24 * 60 * 60;
+
+  struct stat StatBuf;
+  SmallString<128> TimestampFile(Dir);
+  llvm::sys::path::append(TimestampFile, "preambles.timestamp");
+  time_t CurrentTime = time(nullptr);
+  if (!::stat(TimestampFile.c_str(), &StatBuf) &&
+      CurrentTime - StatBuf.st_mtime <= PruneInterval)
+    return;
+
+  // Write a new timestamp file so that nobody else attempts to prune.
+  {
+    std::error_code EC;
+    llvm::raw_fd_ostream Out(TimestampFile, EC, llvm::sys::fs::F_None);
+  }
+
+  std::error_code EC;
+  for (llvm::sys::fs::directory_iterator File(Dir, EC), FileEnd;
+       File != FileEnd && !EC; File.increment(EC)) {
+    StringRef Path = File->path();
+    if (Path == TimestampFile)
+      continue;
+
+    // If the file has been used recently enough, leave it there.
+    if (::stat(Path.str().c_str(), &StatBuf) ||
+        CurrentTime - StatBuf.st_atime <= PruneAfter)
+      continue;
+
+    // A precompiled preamble goes away together with its description, which
+    // is removed first so that no process adopts it in the meantime.
+    StringRef Extension = llvm::sys::path::extension(Path);
+    SmallString<128> Sibling(Path);
+    if (Extension == ".pch") {
+      llvm::sys::path::replace_extension(Sibling, ".preamble");
+      if (llvm::sys::fs::exists(Sibling))
+        continue;
+    }
+    llvm::sys::fs::remove(Path);
+    if (Extension == ".preamble") {
+      llvm::sys::path::replace_extension(Sibling, ".pch");
+      llvm::sys::fs::remove(Sibling);
+    }
+  }
+}
+
+/// \brief Load the description of a preamble that another process stored in
+/// the persistent preamble directory.
+static std::shared_ptr<SharedPreamble> loadPersistentPreamble(StringRef Key) {
+  StringRef Dir = getPersistentPreambleDirectory();
+  if (Dir.empty())
+    return nullptr;
+
+  SmallString<128> PCHPath, InfoPath;
+  getPersistentPreamblePaths(Dir, Key, PCHPath, InfoPath);
+  auto Info = llvm::MemoryBuffer::getFile(InfoPath);
+  if (!Info || !llvm::sys::fs::exists(PCHPath))
+    return nullptr;
+
+  auto P = std::make_shared<SharedPreamble>(PCHPath, /*OwnsPCHFile=*/false);
+  SmallVector<StringRef, 32> Lines;
+  (*Info)->getBuffer().split(Lines, '\n', /*MaxSplit=*/-1,
+                             /*KeepEmpty=*/false);
+  for (StringRef Line : Lines) {
+    StringRef Kind, Rest;
+    std::tie(Kind, Rest) = Line.split(' ');
+    if (Kind == "hash") {
+      if (Rest.getAsInteger(10, P->TopLevelHashValue))
+        return nullptr;
+    } else if (Kind == "decl") {
+      serialization::DeclID ID;
+      if (Rest.getAsInteger(10, ID))
+        return nullptr;
+      P->TopLevelDecls.push_back(ID);
+    } else if (Kind == "file") {
+      StringRef Size, ModTime, Filename;
+      std::tie(Size, Rest) = Rest.split(' ');
+      std::tie(ModTime, Filename) = Rest.split(' ');
+      long long SizeValue, ModTimeValue;
+      if (Size.getAsInteger(10, SizeValue) ||
+          ModTime.getAsInteger(10, ModTimeValue) || Filename.empty())
+        return nullptr;
+      P->FilesInPreamble[Filename] = ASTUnit::PreambleFileHash::createForFile(
+          off_t(SizeValue), time_t(ModTimeValue));
+    } else {
+      return nullptr;
+    }
+  }
+  return P;
+}
+
+/// \brief Write \p Contents to \p Path through a temporary file, so that
+/// other processes never observe a partially written file.
+static bool writeFileAtomically(StringRef Path, StringRef Contents) {
+  SmallString<128> TempPath;
+  int FD;
+  if (llvm::sys::fs::createUniqueFile(Path + "-%%%%%%%%", FD, TempPath))
+    return true;
+
+  {
+    llvm::raw_fd_ostream Out(FD, /*shouldClose=*/true);
+    Out << Contents;
+    Out.close();
+    if (Out.has_error()) {
+      Out.clear_error();
+      llvm::sys::fs::remove(TempPath);
+      return true;
+    }
+  }
+
+  if (llvm::sys::fs::rename(TempPath, Path)) {
+    llvm::sys::fs::remove(TempPath);
+    return true;
+  }
+  return false;
+}
+
+/// \brief Store the preamble \p P in the persistent preamble directory, if
+/// there is one, so that other processes can adopt it.
+static void persistPreamble(StringRef Key, const SharedPreamble &P) {
+  StringRef Dir = getPersistentPreambleDirectory();
+  if (Dir.empty())
+    return;
+
+  // Diagnostics are not persisted, and the contents of unsaved files are
+  // only visible to this process.
+  if (!P.Diagnostics.empty() || P.NumWarnings)
+    return;
+  for (const auto &F : P.FilesInPreamble)
+    if (!F.second.ModTime)
+      return;
+
+  SmallString<128> PCHPath, InfoPath;
+  getPersistentPreamblePaths(Dir, Key, PCHPath, InfoPath);
+  if (llvm::sys::fs::exists(InfoPath) ||
+      llvm::sys::fs::create_directories(Dir))
+    return;
+
+  prunePersistentPreambles(Dir);
+
+  // Write the precompiled preamble first; the description marks the entry as
+  // complete.
+  auto PCH = llvm::MemoryBuffer::getFile(P.PCHFile);
+  if (!PCH || writeFileAtomically(PCHPath, (*PCH)->getBuffer()))
+    return;
+
+  std::string Info;
+  llvm::raw_string_ostream OS(Info);
+  OS << "hash " << P.TopLevelHashValue << '\n';
+  for (serialization::DeclID ID : P.TopLevelDecls)
+    OS << "decl " << ID << '\n';
+  for (const auto &F : P.FilesInPreamble)
+    OS << "file " << (long long)F.second.Size << ' '
+       << (long long)F.second.ModTime << ' ' << F.first() << '\n';
+  writeFileAtomically(InfoPath, OS.str());
+}
+
 /// \brief Attempt to build or re-use a precompiled preamble when (re-)parsing
 /// the source file.
 ///
@@ -1373,71 +1752,9 @@ ASTUnit::getMainBufferWithPrecompiledPreamble(
       // preamble.
 
       // Check that none of the files used by the preamble have changed.
-      bool AnyFileChanged = false;
-          
-      // First, make a record of those files that have been overridden via
-      // remapping or unsaved_files.
-      std::map<llvm::sys::fs::UniqueID, PreambleFileHash> OverriddenFiles;
-      for (const auto &R : PreprocessorOpts.RemappedFiles) {
-        if (AnyFileChanged)
-          break;
-
-        vfs::Status Status;
-        if (FileMgr->getNoncachedStatValue(R.second, Status)) {
-          // If we can't stat the file we're remapping to, assume that something
-          // horrible happened.
-          AnyFileChanged = true;
-          break;
-        }
-
-        OverriddenFiles[Status.getUniqueID()] = PreambleFileHash::createForFile(
-            Status.getSize(),
-            llvm::sys::toTimeT(Status.getLastModificationTime()));
-      }
-
-      for (const auto &RB : PreprocessorOpts.RemappedFileBuffers) {
-        if (AnyFileChanged)
-          break;
-
-        vfs::Status Status;
-        if (FileMgr->getNoncachedStatValue(RB.first, Status)) {
-          AnyFileChanged = true;
-          break;
-        }
-
-        OverriddenFiles[Status.getUniqueID()] =
-            PreambleFileHash::createForMemoryBuffer(RB.second);
-      }
-       
-      // Check whether anything has changed.
-      for (llvm::StringMap<PreambleFileHash>::iterator
-             F = FilesInPreamble.begin(), FEnd = FilesInPreamble.end();
-           !AnyFileChanged && F != FEnd; 
-           ++F) {
-        vfs::Status Status;
-        if (FileMgr->getNoncachedStatValue(F->first(), Status)) {
-          // If we can't stat the file, assume that something horrible happened.
-          AnyFileChanged = true;
-          break;
-        }
+      bool AnyFileChanged =
+          anyPreambleFileChanged(*FileMgr, PreprocessorOpts, FilesInPreamble);
 
-        std::map<llvm::sys::fs::UniqueID, PreambleFileHash>::iterator Overridden
-          = OverriddenFiles.find(Status.getUniqueID());
-        if (Overridden != OverriddenFiles.end()) {
-          // This file was remapped; check whether the newly-mapped file 
-          // matches up with the previous mapping.
-          if (Overridden->second != F->second)
-            AnyFileChanged = true;
-          continue;
-        }
-        
-        // The file was not remapped; check whether it has changed on disk.
-        if (Status.getSize() != uint64_t(F->second.Size) ||
-            llvm::sys::toTimeT(Status.getLastModificationTime()) !=
-                F->second.ModTime)
-          AnyFileChanged = true;
-      }
-          
       if (!AnyFileChanged) {
         // Okay! We can re-use the precompiled preamble.
 
@@ -1477,6 +1794,52 @@ ASTUnit::getMainBufferWithPrecompiledPreamble(
     return nullptr;
   }
 
+  // Before building a new preamble, check whether another ASTUnit in this
+  // process, or another process through the persistent preamble directory,
+  // has already built an identical one that is still up to date.
+  StringRef MainFilename = FrontendOpts.Inputs[0].getFile();
+  std::string PreambleKey = getPreambleCacheKey(
+      *PreambleInvocation, MainFilename,
+      NewPreamble.Buffer->getBuffer().slice(0, NewPreamble.Size),
+      NewPreamble.PreambleEndsAtStartOfLine);
+  std::shared_ptr<SharedPreamble> Cached = findSharedPreamble(PreambleKey);
+  if (!Cached)
+    Cached = loadPersistentPreamble(PreambleKey);
+  if (Cached && !anyPreambleFileChanged(*FileMgr, PreprocessorOpts,
+                                        Cached->FilesInPreamble)) {
+    registerSharedPreamble(PreambleKey, Cached);
+    setSharedPreamble(this, Cached);
+
+    Preamble.assign(FileMgr->getFile(MainFilename),
+                    NewPreamble.Buffer->getBufferStart(),
+                    NewPreamble.Buffer->getBufferStart() + NewPreamble.Size);
+    PreambleEndsAtStartOfLine = NewPreamble.PreambleEndsAtStartOfLine;
+    OriginalSourceFile = MainFilename;
+    FilesInPreamble = Cached->FilesInPreamble;
+    TopLevelDeclsInPreamble = Cached->TopLevelDecls;
+    PreambleDiagnostics = Cached->Diagnostics;
+    NumWarningsInPreamble = Cached->NumWarnings;
+    TopLevelDecls.clear();
+    checkAndRemoveNonDriverDiags(StoredDiagnostics);
+
+    // Set the state of the diagnostic object to mimic its state after
+    // parsing the preamble.
+    getDiagnostics().Reset();
+    ProcessWarningOptions(getDiagnostics(),
+                          PreambleInvocation->getDiagnosticOpts());
+    getDiagnostics().setNumWarnings(NumWarningsInPreamble);
+
+    CurrentTopLevelHashValue = Cached->TopLevelHashValue;
+    if (CurrentTopLevelHashValue != PreambleTopLevelHashValue) {
+      CompletionCacheTopLevelHashValue = 0;
+      PreambleTopLevelHashValue = CurrentTopLevelHashValue;
+    }
+
+    PreambleRebuildCounter = 1;
+    return llvm::MemoryBuffer::getMemBufferCopy(
+        NewPreamble.Buffer->getBuffer(), MainFilename);
+  }
+
   // Create a temporary file for the precompiled preamble. In rare 
   // circumstances, this can fail.
   std::string PreamblePCHPath = GetPreamblePCHPath();
@@ -1492,7 +1855,6 @@ ASTUnit::getMainBufferWithPrecompiledPreamble(
 
   // Save the preamble text for later; we'll need to compare against it for
   // subsequent reparses.
-  StringRef MainFilename = FrontendOpts.Inputs[0].getFile();
   Preamble.assign(FileMgr->getFile(MainFilename),
                   NewPreamble.Buffer->getBufferStart(),
                   NewPreamble.Buffer->getBufferStart() + NewPreamble.Size);
@@ -1610,7 +1972,9 @@ ASTUnit::getMainBufferWithPrecompiledPreamble(
   }
   
   // Keep track of the preamble we precompiled.
-  setPreambleFile(this, FrontendOpts.OutputFile);
+  auto Built = std::make_shared<SharedPreamble>(FrontendOpts.OutputFile,
+                                                /*OwnsPCHFile=*/true);
+  setSharedPreamble(this, Built);
   NumWarningsInPreamble = getDiagnostics().getNumWarnings();
   
   // Keep track of all of the files that the source manager knows about,
@@ -1642,6 +2006,16 @@ ASTUnit::getMainBufferWithPrecompiledPreamble(
     PreambleTopLevelHashValue = CurrentTopLevelHashValue;
   }
 
+  // Make the preamble available to other ASTUnits and processes that compute
+  // the same preamble.
+  Built->FilesInPreamble = FilesInPreamble;
+  Built->TopLevelDecls = TopLevelDeclsInPreamble;
+  Built->Diagnostics = PreambleDiagnostics;
+  Built->NumWarnings = NumWarningsInPreamble;
+  Built->TopLevelHashValue = CurrentTopLevelHashValue;
+  registerSharedPreamble(PreambleKey, Built);
+  persistPreamble(PreambleKey, *Built);
+
   return llvm::MemoryBuffer::getMemBufferCopy(NewPreamble.Buffer->getBuffer(),
                                               MainFilename);
 }
@@ -2516,7 +2890,7 @@ bool ASTUnit::serialize(raw_ostream &OS) {
 
   SmallString<128> Buffer;
   llvm::BitstreamWriter Stream(Buffer);
-  ASTWriter Writer(Stream, { });
+  ASTWriter Writer(Stream, Buffer, { });
   return serializeUnit(Writer, Buffer, getSema(), hasErrors, OS);
 }
 
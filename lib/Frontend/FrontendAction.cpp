@@ -184,6 +184,12 @@ FrontendAction::CreateWrappedASTConsumer(CompilerInstance &CI,
     Consumers.push_back(std::move(C));
   }
 
+  if (Consumers.size() == 1)
+    return std::move(Consumers.front());
+
+  // The plugins may look at function bodies after code has been generated
+  // for them, so the bodies must not be released.
+  CI.getLangOpts().FreeFunctionBodies = false;
   return llvm::make_unique<MultiplexConsumer>(std::move(Consumers));
 }
 
@@ -485,6 +491,17 @@ void FrontendAction::EndSourceFile() {
   // Finalize the action.
   EndSourceFileAction();
 
+  StringRef ASTMemoryStatsFile = CI.getFrontendOpts().ASTMemoryStatsFile;
+  if (!ASTMemoryStatsFile.empty() && CI.hasASTContext()) {
+    std::error_code EC;
+    llvm::raw_fd_ostream OS(ASTMemoryStatsFile, EC, llvm::sys::fs::F_Text);
+    if (EC)
+      CI.getDiagnostics().Report(diag::warn_fe_unable_to_open_stats_file)
+          << ASTMemoryStatsFile << EC.message();
+    else
+      PrintASTMemoryStats(CI.getASTContext(), OS);
+  }
+
   // Sema references the ast consumer, so reset sema first.
   //
   // FIXME: There is more per-file stuff we could just drop here?
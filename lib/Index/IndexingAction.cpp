@@ -10,6 +10,7 @@
 #include "clang/Index/IndexingAction.h"
 #include "clang/Index/IndexDataConsumer.h"
 #include "IndexingContext.h"
+#include "clang/Frontend/CompilerInstance.h"
 #include "clang/Frontend/FrontendAction.h"
 #include "clang/Frontend/MultiplexConsumer.h"
 #include "clang/Lex/Preprocessor.h"
@@ -139,6 +140,10 @@ WrappingIndexAction::CreateASTConsumer(CompilerInstance &CI, StringRef InFile) {
     return nullptr;
   }
 
+  // The index consumer sees each declaration after the wrapped consumer, which
+  // may have generated code for it; keep the function bodies for indexing.
+  CI.getLangOpts().FreeFunctionBodies = false;
+
   std::vector<std::unique_ptr<ASTConsumer>> Consumers;
   Consumers.push_back(std::move(OtherConsumer));
   Consumers.push_back(createIndexASTConsumer());
@@ -15,6 +15,7 @@
 #include "clang/Lex/Preprocessor.h"
 #include "clang/Basic/FileManager.h"
 #include "clang/Basic/SourceManager.h"
+#include "clang/Basic/TimeTrace.h"
 #include "clang/Lex/HeaderSearch.h"
 #include "clang/Lex/LexDiagnostic.h"
 #include "clang/Lex/MacroInfo.h"
@@ -121,6 +122,15 @@ void Preprocessor::EnterSourceFileWithLexer(Lexer *TheLexer,
   if (CurLexerKind != CLK_LexAfterModuleImport)
     CurLexerKind = CLK_Lexer;
 
+  // Record the time spent lexing each #included file. The parser does not
+  // leave a header at a declaration boundary, so these events go on a track
+  // of their own.
+  if (timeTraceProfilerEnabled() && !IncludeMacroStack.empty() &&
+      !CurLexer->Is_PragmaLexer)
+    if (const FileEntry *FE =
+            SourceMgr.getFileEntryForID(CurLexer->getFileID()))
+      timeTraceProfilerBegin("Source", FE->getName(), TTT_Source);
+
   // Notify the client, if desired, that we are in a new source file.
   if (Callbacks && !CurLexer->Is_PragmaLexer) {
     SrcMgr::CharacteristicKind FileType =
@@ -415,6 +425,10 @@ bool Preprocessor::HandleEndOfFile(Token &Result, bool isEndOfMacro) {
       LeaveSubmodule();
     }
 
+    if (timeTraceProfilerEnabled() && CurLexer && !CurLexer->Is_PragmaLexer &&
+        SourceMgr.getFileEntryForID(CurLexer->getFileID()))
+      timeTraceProfilerEnd(TTT_Source);
+
     // We're done with the #included file.
     RemoveTopOfLexerStack();
 
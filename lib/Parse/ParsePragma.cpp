@@ -865,25 +865,33 @@ bool Parser::HandlePragmaLoopHint(LoopHint &Hint) {
 
   // If no option is specified the argument is assumed to be a constant expr.
   bool OptionUnroll = false;
-  bool OptionDistribute = false;
+  bool OptionPipeline = false;
   bool StateOption = false;
+  bool AssumeSafetyArg = false;
   if (OptionInfo) { // Pragma Unroll does not specify an option.
     OptionUnroll = OptionInfo->isStr("unroll");
-    OptionDistribute = OptionInfo->isStr("distribute");
+    OptionPipeline = OptionInfo->isStr("pipeline");
+    AssumeSafetyArg = llvm::StringSwitch<bool>(OptionInfo->getName())
+                          .Case("vectorize", true)
+                          .Case("interleave", true)
+                          .Default(false);
     StateOption = llvm::StringSwitch<bool>(OptionInfo->getName())
-                      .Case("vectorize", true)
-                      .Case("interleave", true)
+                      .Case("distribute", true)
+                      .Case("unroll_and_jam", true)
+                      .Case("vectorize_predicate", true)
                       .Default(false) ||
-                  OptionUnroll || OptionDistribute;
+                  OptionUnroll || OptionPipeline || AssumeSafetyArg;
   }
 
-  bool AssumeSafetyArg = !OptionUnroll && !OptionDistribute;
   // Verify loop hint has an argument.
   if (Toks[0].is(tok::eof)) {
     ConsumeToken(); // The annotation token.
-    Diag(Toks[0].getLocation(), diag::err_pragma_loop_missing_argument)
-        << /*StateArgument=*/StateOption << /*FullKeyword=*/OptionUnroll
-        << /*AssumeSafetyKeyword=*/AssumeSafetyArg;
+    if (OptionPipeline)
+      Diag(Toks[0].getLocation(), diag::err_pragma_pipeline_invalid_keyword);
+    else
+      Diag(Toks[0].getLocation(), diag::err_pragma_loop_missing_argument)
+          << /*StateArgument=*/StateOption << /*FullKeyword=*/OptionUnroll
+          << /*AssumeSafetyKeyword=*/AssumeSafetyArg;
     return false;
   }
 
@@ -895,14 +903,18 @@ bool Parser::HandlePragmaLoopHint(LoopHint &Hint) {
 
     bool Valid = StateInfo &&
                  llvm::StringSwitch<bool>(StateInfo->getName())
-                     .Cases("enable", "disable", true)
+                     .Case("disable", true)
+                     .Case("enable", !OptionPipeline)
                      .Case("full", OptionUnroll)
                      .Case("assume_safety", AssumeSafetyArg)
                      .Default(false);
     if (!Valid) {
-      Diag(Toks[0].getLocation(), diag::err_pragma_invalid_keyword)
-          << /*FullKeyword=*/OptionUnroll
-          << /*AssumeSafetyKeyword=*/AssumeSafetyArg;
+      if (OptionPipeline)
+        Diag(Toks[0].getLocation(), diag::err_pragma_pipeline_invalid_keyword);
+      else
+        Diag(Toks[0].getLocation(), diag::err_pragma_invalid_keyword)
+            << /*FullKeyword=*/OptionUnroll
+            << /*AssumeSafetyKeyword=*/AssumeSafetyArg;
       return false;
     }
     if (Toks.size() > 2)
@@ -2002,6 +2014,16 @@ static bool ParseLoopHintValue(Preprocessor &PP, Token &Tok, Token PragmaName,
 ///    'vectorize_width' '(' loop-hint-value ')'
 ///    'interleave_count' '(' loop-hint-value ')'
 ///    'unroll_count' '(' loop-hint-value ')'
+///    'distribute' '(' state-hint-keyword ')'
+///    'unroll_and_jam' '(' state-hint-keyword ')'
+///    'unroll_and_jam_count' '(' loop-hint-value ')'
+///    'vectorize_predicate' '(' state-hint-keyword ')'
+///    'pipeline' '(' 'disable' ')'
+///    'pipeline_initiation_interval' '(' loop-hint-value ')'
+///
+///  state-hint-keyword:
+///    'enable'
+///    'disable'
 ///
 ///  loop-hint-keyword:
 ///    'enable'
@@ -2034,6 +2056,15 @@ static bool ParseLoopHintValue(Preprocessor &PP, Token &Tok, Token PragmaName,
 /// compile time.  Specifying unroll(disable) disables unrolling for the
 /// loop. Specifying unroll_count(_value_) instructs llvm to try to unroll the
 /// loop the number of times indicated by the value.
+///
+/// The unroll_and_jam and unroll_and_jam_count directives control the
+/// unroll-and-jam transformation of outer loops, which unrolls the loop and
+/// fuses the resulting copies of its inner loop. Specifying
+/// vectorize_predicate(enable) asks the vectorizer to fold the remainder of
+/// the loop into the vector body using predication instead of emitting a
+/// scalar epilogue. Specifying pipeline(disable) disables software pipelining
+/// of the loop, and pipeline_initiation_interval(_value_) requests an
+/// initiation interval of the given number of cycles.
 void PragmaLoopHintHandler::HandlePragma(Preprocessor &PP,
                                          PragmaIntroducerKind Introducer,
                                          Token &Tok) {
@@ -2061,6 +2092,11 @@ void PragmaLoopHintHandler::HandlePragma(Preprocessor &PP,
                            .Case("vectorize_width", true)
                            .Case("interleave_count", true)
                            .Case("unroll_count", true)
+                           .Case("unroll_and_jam", true)
+                           .Case("unroll_and_jam_count", true)
+                           .Case("vectorize_predicate", true)
+                           .Case("pipeline", true)
+                           .Case("pipeline_initiation_interval", true)
                            .Default(false);
     if (!OptionValid) {
       PP.Diag(Tok.getLocation(), diag::err_pragma_loop_invalid_option)
@@ -531,6 +531,13 @@ struct CheckFallThroughDiagnostics {
 
 } // anonymous namespace
 
+/// \brief Determine whether the last statement of \p Body is a return
+/// statement, so that control cannot reach the end of the body.
+static bool endsInReturn(const Stmt *Body) {
+  const auto *CS = dyn_cast<CompoundStmt>(Body);
+  return CS && !CS->body_empty() && isa<ReturnStmt>(CS->body_back());
+}
+
 /// CheckFallThroughForFunctionDef - Check that we don't fall off the end of a
 /// function that should return a value.  Check that we don't fall off the end
 /// of a noreturn function.  We assume that functions and blocks not marked
@@ -571,6 +578,12 @@ static void CheckFallThroughForBody(Sema &S, const Decl *D, const Stmt *Body,
   if (CD.checkDiagnostics(Diags, ReturnsVoid, HasNoReturn))
       return;
 
+  // A body that ends in a return statement cannot fall off its end. The CFG
+  // would only tell us whether that return is reachable, which matters only
+  // when suggesting 'noreturn' for a function that returns void.
+  if ((!ReturnsVoid || HasNoReturn) && endsInReturn(Body))
+    return;
+
   SourceLocation LBrace = Body->getLocStart(), RBrace = Body->getLocEnd();
   // Either in a function body compound statement, or a function-try-block.
   switch (CheckFallThrough(AC)) {
@@ -371,6 +371,9 @@ void Sema::addExternalSource(ExternalSemaSource *E) {
 void Sema::PrintStats() const {
   llvm::errs() << "\n*** Semantic Analysis Stats:\n";
   llvm::errs() << NumSFINAEErrors << " SFINAE diagnostics trapped.\n";
+  llvm::errs() << NumStandardConversionLookups
+               << " cacheable standard conversion checks, "
+               << NumStandardConversionCacheHits << " cache hits.\n";
 
   BumpAlloc.PrintStats();
   AnalysisWarnings.PrintStats();
@@ -728,6 +731,28 @@ void Sema::ActOnEndOfTranslationUnit() {
     if (LateTemplateParserCleanup)
       LateTemplateParserCleanup(OpaqueParser);
 
+    CheckDelayedMemberExceptionSpecs();
+  } else if (LangOpts.PCHInstantiateTemplates) {
+    // Perform the implicit instantiations the prefix needs now, so that they
+    // are written to the AST file and reused by every translation unit that
+    // includes it instead of being repeated in each of them. Validation of
+    // the AST file's inputs and language options keeps the instantiations
+    // consistent with the headers they were performed from.
+    if (ExternalSource) {
+      SmallVector<PendingImplicitInstantiation, 4> Pending;
+      ExternalSource->ReadPendingInstantiations(Pending);
+      PendingInstantiations.insert(PendingInstantiations.begin(),
+                                   Pending.begin(), Pending.end());
+    }
+    PerformPendingInstantiations();
+
+    // Instantiations of templates that are not defined yet are left to the
+    // users of the prefix.
+    PendingInstantiations.insert(PendingInstantiations.end(),
+                                 DeferredPrefixInstantiations.begin(),
+                                 DeferredPrefixInstantiations.end());
+    DeferredPrefixInstantiations.clear();
+
     CheckDelayedMemberExceptionSpecs();
   }
 
@@ -1164,6 +1189,7 @@ Scope *Sema::getScopeForContext(DeclContext *Ctx) {
 
 /// \brief Enter a new function scope
 void Sema::PushFunctionScope() {
+  SavedFunctionBodyArenas.push_back(suspendFunctionBodyArena());
   if (FunctionScopes.size() == 1) {
     // Use the "top" function scope rather than having to allocate
     // memory for a new scope.
@@ -1176,11 +1202,17 @@ void Sema::PushFunctionScope() {
 }
 
 void Sema::PushBlockScope(Scope *BlockScope, BlockDecl *Block) {
+  // Blocks may be emitted apart from the function that contains them.
+  retainFunctionBody();
+  SavedFunctionBodyArenas.push_back(suspendFunctionBodyArena());
   FunctionScopes.push_back(new BlockScopeInfo(getDiagnostics(),
                                               BlockScope, Block));
 }
 
 LambdaScopeInfo *Sema::PushLambdaScope() {
+  // The closure type and its call operator outlive the enclosing body.
+  retainFunctionBody();
+  SavedFunctionBodyArenas.push_back(suspendFunctionBodyArena());
   LambdaScopeInfo *const LSI = new LambdaScopeInfo(getDiagnostics());
   FunctionScopes.push_back(LSI);
   return LSI;
@@ -1209,6 +1241,23 @@ void Sema::PopFunctionScopeInfo(const AnalysisBasedWarnings::Policy *WP,
 
   if (FunctionScopes.back() != Scope)
     delete Scope;
+
+  restoreFunctionBodyArena(SavedFunctionBodyArenas.pop_back_val());
+}
+
+FunctionBodyArena *Sema::suspendFunctionBodyArena() {
+  FunctionBodyArena *Arena = Context.getActiveBodyArena();
+  Context.setActiveBodyArena(nullptr);
+  return Arena;
+}
+
+void Sema::restoreFunctionBodyArena(FunctionBodyArena *Arena) {
+  Context.setActiveBodyArena(Arena);
+}
+
+void Sema::retainFunctionBody() {
+  if (FunctionBodyArena *Arena = Context.getActiveBodyArena())
+    Arena->Retained = true;
 }
 
 void Sema::PushCompoundScope() {
@@ -1559,6 +1608,8 @@ void Sema::PushCapturedRegionScope(Scope *S, CapturedDecl *CD, RecordDecl *RD,
       getDiagnostics(), S, CD, RD, CD->getContextParam(), K,
       (getLangOpts().OpenMP && K == CR_OpenMP) ? getOpenMPNestingLevel() : 0);
   CSI->ReturnType = Context.VoidTy;
+  retainFunctionBody();
+  SavedFunctionBodyArenas.push_back(suspendFunctionBodyArena());
   FunctionScopes.push_back(CSI);
 }
 
@@ -10607,6 +10607,47 @@ Sema::ActOnCXXForRangeIdentifier(Scope *S, SourceLocation IdentLoc,
                        AttrEnd.isValid() ? AttrEnd : IdentLoc);
 }
 
+/// \brief Determine whether \p Init initializes an array, or an array of
+/// arrays, whose elements are all (possibly negated) numeric literals with at
+/// most an implicit arithmetic conversion.
+///
+/// Such an initializer is always a constant expression. Evaluating it up front
+/// would create an APValue for every element of what can be a very large table
+/// that CodeGen emits directly from the literals.
+static bool isNumericLiteralArrayInit(const Expr *Init) {
+  const auto *ILE = dyn_cast<InitListExpr>(Init->IgnoreParens());
+  if (!ILE || !ILE->getType()->isArrayType())
+    return false;
+  if (const Expr *Filler = ILE->getArrayFiller())
+    if (!isa<ImplicitValueInitExpr>(Filler))
+      return false;
+
+  for (const Expr *E : ILE->inits()) {
+    if (isa<ImplicitValueInitExpr>(E))
+      continue;
+    if (isNumericLiteralArrayInit(E))
+      continue;
+
+    E = E->IgnoreParens();
+    if (const auto *Cast = dyn_cast<ImplicitCastExpr>(E)) {
+      if (Cast->getCastKind() != CK_IntegralCast &&
+          Cast->getCastKind() != CK_FloatingCast &&
+          Cast->getCastKind() != CK_IntegralToFloating)
+        return false;
+      E = Cast->getSubExpr()->IgnoreParens();
+    }
+    if (const auto *UO = dyn_cast<UnaryOperator>(E)) {
+      if (UO->getOpcode() != UO_Minus)
+        return false;
+      E = UO->getSubExpr()->IgnoreParens();
+    }
+    if (!isa<IntegerLiteral>(E) && !isa<CharacterLiteral>(E) &&
+        !isa<FloatingLiteral>(E))
+      return false;
+  }
+  return true;
+}
+
 void Sema::CheckCompleteVariableDeclaration(VarDecl *var) {
   if (var->isInvalidDecl()) return;
 
@@ -10768,8 +10809,11 @@ void Sema::CheckCompleteVariableDeclaration(VarDecl *var) {
       Init && !Init->isValueDependent()) {
 
     if (var->isConstexpr()) {
+      // Tables of numeric literals are constant; leave their evaluation to
+      // the expressions that use their values, if any.
       SmallVector<PartialDiagnosticAt, 8> Notes;
-      if (!var->evaluateValue(Notes) || !var->isInitICE()) {
+      if (!isNumericLiteralArrayInit(Init) &&
+          (!var->evaluateValue(Notes) || !var->isInitICE())) {
         SourceLocation DiagLoc = var->getLocation();
         // If the note doesn't add any useful information other than a source
         // location, fold it into the primary diagnostic.
@@ -10847,6 +10891,14 @@ Sema::FinalizeDeclaration(Decl *ThisDecl) {
   // Note that we are no longer parsing the initializer for this declaration.
   ParsingInitForAutoVars.erase(ThisDecl);
 
+  // The initializers and attributes of local static and extern declarations
+  // are referred to from outside of the function body.
+  if (ThisDecl && ThisDecl->getLexicalDeclContext()->isFunctionOrMethod()) {
+    VarDecl *Var = dyn_cast<VarDecl>(ThisDecl);
+    if (ThisDecl->isLocalExternDecl() || (Var && Var->isStaticLocal()))
+      retainFunctionBody();
+  }
+
   VarDecl *VD = dyn_cast_or_null<VarDecl>(ThisDecl);
   if (!VD)
     return;
@@ -11633,6 +11685,31 @@ static void RebuildLambdaScopeInfo(CXXMethodDecl *CallOperator,
   }
 }
 
+bool Sema::isReleasableFunctionBody(const FunctionDecl *FD) const {
+  // Statements deserialized from an AST file while the body is being built
+  // would end up in its arena.
+  if (ExternalSource || Context.getExternalSource())
+    return false;
+
+  // Offloading and Objective-C compilations refer to bodies from elsewhere.
+  if (getLangOpts().CUDA || getLangOpts().OpenMP || getLangOpts().ObjC1)
+    return false;
+
+  // Templates are instantiated from their bodies, and inline and constexpr
+  // functions may be emitted or evaluated again after they were emitted.
+  if (FD->getTemplatedKind() != FunctionDecl::TK_NonTemplate ||
+      FD->isDependentContext() || FD->isInlined() || FD->isConstexpr() ||
+      FD->isLateTemplateParsed())
+    return false;
+
+  // Constructors and destructors are emitted once per variant.
+  if (isa<CXXConstructorDecl>(FD) || isa<CXXDestructorDecl>(FD))
+    return false;
+
+  // So are the member functions of local classes.
+  return !FD->getParentFunctionOrMethod();
+}
+
 Decl *Sema::ActOnStartOfFunctionDef(Scope *FnBodyScope, Decl *D,
                                     SkipBodyInfo *SkipBody) {
   // Clear the last template instantiation error context.
@@ -11680,6 +11757,11 @@ Decl *Sema::ActOnStartOfFunctionDef(Scope *FnBodyScope, Decl *D,
     // Enter a new function scope
     PushFunctionScope();
 
+  // Allocate the statements of a body that nothing refers to once code has
+  // been generated for it in an arena that CodeGen can release.
+  if (getLangOpts().FreeFunctionBodies && isReleasableFunctionBody(FD))
+    Context.setActiveBodyArena(Context.createFunctionBodyArena(FD));
+
   // Builtin functions cannot be defined.
   if (unsigned BuiltinID = FD->getBuiltinID()) {
     if (!Context.BuiltinInfo.isPredefinedLibFunction(BuiltinID) &&
@@ -13565,6 +13647,9 @@ void Sema::ActOnTagStartDefinition(Scope *S, Decl *TagD) {
   // Enter the tag context.
   PushDeclContext(S, Tag);
 
+  // Members of local classes are emitted apart from the enclosing function.
+  retainFunctionBody();
+
   ActOnDocumentableDecl(TagD);
 
   // If there's a #pragma GCC visibility in scope, set the visibility of this
@@ -1200,6 +1200,16 @@ bool Sema::isFunctionConsideredUnavailable(FunctionDecl *FD) {
   return true;
 }
 
+/// \brief Determine whether a type only takes part in standard conversions
+/// that are fully determined by the type itself.
+static bool isSimpleConversionType(QualType T) {
+  if (const PointerType *PT = T->getAs<PointerType>())
+    T = PT->getPointeeType();
+  if (const EnumType *ET = T->getAs<EnumType>())
+    return ET->getDecl()->isComplete();
+  return T->isArithmeticType() || T->isVoidType();
+}
+
 /// \brief Tries a user-defined conversion from From to ToType.
 ///
 /// Produces an implicit conversion sequence for when a standard conversion
@@ -1221,6 +1231,13 @@ TryUserDefinedConversion(Sema &S, Expr *From, QualType ToType,
     return ICS;
   }
 
+  // Only classes have converting constructors and conversion functions, so
+  // don't bother with overload resolution if neither type can involve one.
+  if (!ToType->getAs<RecordType>() && isSimpleConversionType(From->getType())) {
+    ICS.setBad(BadConversionSequence::no_conversion, From, ToType);
+    return ICS;
+  }
+
   // Attempt user-defined conversion.
   OverloadCandidateSet Conversions(From->getExprLoc(),
                                    OverloadCandidateSet::CSK_Normal);
@@ -1544,6 +1561,33 @@ static bool tryAtomicConversion(Sema &S, Expr *From, QualType ToType,
                                 StandardConversionSequence &SCS,
                                 bool CStyle);
 
+/// \brief Determine whether the result of IsStandardConversion for \p From
+/// and \p ToType only depends on the types involved, and can be cached.
+///
+/// This is the case for conversions between arithmetic types, complete
+/// enumerations and pointers to them, unless the source might be a bit-field
+/// or a null pointer constant, whose conversions depend on the expression.
+/// Conversions involving classes are never cached, since their outcome can
+/// change once a class is completed.
+static bool isCacheableStandardConversion(Sema &S, Expr *From,
+                                          QualType ToType) {
+  if (!S.getLangOpts().CPlusPlus)
+    return false;
+
+  QualType FromType = From->getType();
+  if (!isSimpleConversionType(FromType) || !isSimpleConversionType(ToType))
+    return false;
+  if (ToType->isPointerType() && !FromType->isPointerType())
+    return false;
+  return !From->getSourceBitField();
+}
+
+static bool ComputeStandardConversion(Sema &S, Expr* From, QualType ToType,
+                                      bool InOverloadResolution,
+                                      StandardConversionSequence &SCS,
+                                      bool CStyle,
+                                      bool AllowObjCWritebackConversion);
+
 /// IsStandardConversion - Determines whether there is a standard
 /// conversion sequence (C++ [conv], C++ [over.ics.scs]) from the
 /// expression From to the type ToType. Standard conversion sequences
@@ -1557,6 +1601,47 @@ static bool IsStandardConversion(Sema &S, Expr* From, QualType ToType,
                                  StandardConversionSequence &SCS,
                                  bool CStyle,
                                  bool AllowObjCWritebackConversion) {
+  if (!isCacheableStandardConversion(S, From, ToType))
+    return ComputeStandardConversion(S, From, ToType, InOverloadResolution,
+                                     SCS, CStyle, AllowObjCWritebackConversion);
+
+  // The result is keyed on the types as written, so that the cached
+  // conversion sequence refers to the same type sugar as a fresh one.
+  unsigned Flags = From->isGLValue() | InOverloadResolution << 1 |
+                   CStyle << 2 | AllowObjCWritebackConversion << 3;
+  Sema::StandardConversionKey Key(
+      std::make_pair(From->getType().getAsOpaquePtr(),
+                     ToType.getAsOpaquePtr()),
+      Flags);
+
+  if (!S.StandardConversionCache)
+    S.StandardConversionCache.reset(
+        new llvm::DenseMap<Sema::StandardConversionKey,
+                           CachedStandardConversion>());
+  ++S.NumStandardConversionLookups;
+
+  auto Known = S.StandardConversionCache->find(Key);
+  if (Known != S.StandardConversionCache->end()) {
+    ++S.NumStandardConversionCacheHits;
+    SCS = Known->second.SCS;
+    return Known->second.Success;
+  }
+
+  CachedStandardConversion Result;
+  Result.Success = ComputeStandardConversion(S, From, ToType,
+                                             InOverloadResolution, Result.SCS,
+                                             CStyle,
+                                             AllowObjCWritebackConversion);
+  SCS = Result.SCS;
+  S.StandardConversionCache->insert(std::make_pair(Key, Result));
+  return Result.Success;
+}
+
+static bool ComputeStandardConversion(Sema &S, Expr* From, QualType ToType,
+                                      bool InOverloadResolution,
+                                      StandardConversionSequence &SCS,
+                                      bool CStyle,
+                                      bool AllowObjCWritebackConversion) {
   QualType FromType = From->getType();
 
   // Standard conversions (C++ [conv])
@@ -19,6 +19,7 @@
 #include "clang/AST/Expr.h"
 #include "clang/AST/ExprCXX.h"
 #include "clang/AST/TypeLoc.h"
+#include "clang/Basic/TimeTrace.h"
 #include "clang/Sema/Initialization.h"
 #include "clang/Sema/Lookup.h"
 #include "clang/Sema/PrettyDeclStackTrace.h"
@@ -3700,6 +3701,14 @@ void Sema::InstantiateFunctionDefinition(SourceLocation PointOfInstantiation,
       !Function->getClassScopeSpecializationPattern())
     return;
 
+  TimeTraceScope TimeScope("InstantiateFunction", [&]() {
+    std::string Name;
+    llvm::raw_string_ostream OS(Name);
+    Function->getNameForDiagnostic(OS, getPrintingPolicy(),
+                                   /*Qualified=*/true);
+    return OS.str();
+  });
+
   // Find the function body that we'll be substituting.
   const FunctionDecl *PatternDecl = Function->getTemplateInstantiationPattern();
   assert(PatternDecl && "instantiating a non-template");
@@ -3711,13 +3720,22 @@ void Sema::InstantiateFunctionDefinition(SourceLocation PointOfInstantiation,
     PatternDecl = PatternDef;
   }
 
+  // When building a translation unit prefix, a template that is not defined
+  // yet may still be defined by the translation units that use the prefix.
+  bool DeferToPrefixUsers = AtEndOfTU && TUKind == TU_Prefix &&
+                            getLangOpts().PCHInstantiateTemplates;
+
   // FIXME: We need to track the instantiation stack in order to know which
   // definitions should be visible within this instantiation.
   if (DiagnoseUninstantiableTemplate(PointOfInstantiation, Function,
                                 Function->getInstantiatedFromMemberFunction(),
                                      PatternDecl, PatternDef, TSK,
-                                     /*Complain*/DefinitionRequired)) {
-    if (DefinitionRequired)
+                                     /*Complain*/DefinitionRequired &&
+                                         !DeferToPrefixUsers)) {
+    if (DeferToPrefixUsers)
+      DeferredPrefixInstantiations.push_back(
+          std::make_pair(Function, PointOfInstantiation));
+    else if (DefinitionRequired)
       Function->setInvalidDecl();
     else if (TSK == TSK_ExplicitInstantiationDefinition) {
       // Try again at the end of the translation unit (at which point a
@@ -4275,7 +4293,12 @@ void Sema::InstantiateVariableDefinition(SourceLocation PointOfInstantiation,
   // definition (or provide a specialization for it) in another translation
   // unit.
   if (!Def && !DefinitionRequired) {
-    if (TSK == TSK_ExplicitInstantiationDefinition) {
+    if (AtEndOfTU && TUKind == TU_Prefix &&
+        getLangOpts().PCHInstantiateTemplates) {
+      // The translation units that use this prefix may define the template.
+      DeferredPrefixInstantiations.push_back(
+          std::make_pair(Var, PointOfInstantiation));
+    } else if (TSK == TSK_ExplicitInstantiationDefinition) {
       PendingInstantiations.push_back(
         std::make_pair(Var, PointOfInstantiation));
     } else if (TSK == TSK_ImplicitInstantiation) {
@@ -5063,6 +5086,7 @@ NamedDecl *Sema::FindInstantiatedDecl(SourceLocation Loc, NamedDecl *D,
 /// \brief Performs template instantiation for all implicit template
 /// instantiations we have seen until this point.
 void Sema::PerformPendingInstantiations(bool LocalOnly) {
+  TimeTraceScope TimeScope("PerformPendingInstantiations");
   while (!PendingLocalImplicitInstantiations.empty() ||
          (!LocalOnly && !PendingInstantiations.empty())) {
     PendingImplicitInstantiation Inst;
@@ -2478,6 +2478,18 @@ ASTReader::ReadControlBlock(ModuleFile &F,
     case MODULE_DIRECTORY: {
       assert(!F.ModuleName.empty() &&
              "MODULE_DIRECTORY found before MODULE_NAME");
+      // A module directory written relative to the path root of the build is
+      // relative to our own path root.
+      std::string ModuleDir = Blob;
+      const std::string &PathRoot =
+          PP.getHeaderSearchInfo().getHeaderSearchOpts().ASTFilePathRoot;
+      if (!PathRoot.empty() && llvm::sys::path::is_relative(ModuleDir)) {
+        SmallString<128> Resolved(PathRoot);
+        llvm::sys::path::append(Resolved, ModuleDir);
+        llvm::sys::path::remove_dots(Resolved);
+        ModuleDir = Resolved.str();
+      }
+
       // If we've already loaded a module map file covering this module, we may
       // have a better path for it (relative to the current build).
       Module *M = PP.getHeaderSearchInfo().lookupModule(F.ModuleName);
@@ -2486,17 +2498,17 @@ ASTReader::ReadControlBlock(ModuleFile &F,
         // change between the build and use.
         if (F.Kind != MK_ExplicitModule && F.Kind != MK_PrebuiltModule) {
           const DirectoryEntry *BuildDir =
-              PP.getFileManager().getDirectory(Blob);
+              PP.getFileManager().getDirectory(ModuleDir);
           if (!BuildDir || BuildDir != M->Directory) {
             if ((ClientLoadCapabilities & ARR_OutOfDate) == 0)
               Diag(diag::err_imported_module_relocated)
-                  << F.ModuleName << Blob << M->Directory->getName();
+                  << F.ModuleName << ModuleDir << M->Directory->getName();
             return OutOfDate;
           }
         }
         F.BaseDirectory = M->Directory->getName();
       } else {
-        F.BaseDirectory = Blob;
+        F.BaseDirectory = ModuleDir;
       }
       break;
     }
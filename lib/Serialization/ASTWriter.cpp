@@ -74,6 +74,7 @@
 #include "llvm/Support/Compression.h"
 #include "llvm/Support/EndianStream.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/MD5.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/OnDiskHashTable.h"
 #include "llvm/Support/Path.h"
@@ -1312,6 +1313,42 @@ static ASTFileSignature getSignature() {
   }
 }
 
+/// \brief Compute the signature of a module file that must be reproducible
+/// from its contents \p Bytes, with the signature itself still zero.
+///
+/// The file covers everything the module depends on: the options it was
+/// built with, the signatures of the modules it imports and the serialized
+/// AST. The contents of the input files, which the AST only reflects in part,
+/// are hashed as well, in an order that does not depend on where the files
+/// live or the order in which they were loaded.
+static ASTFileSignature getContentSignature(ArrayRef<char> Bytes,
+                                            const SourceManager &SM) {
+  std::vector<std::string> Digests;
+  for (auto I = SM.fileinfo_begin(), E = SM.fileinfo_end(); I != E; ++I) {
+    const llvm::MemoryBuffer *Buffer = I->second->getRawBuffer();
+    if (!Buffer)
+      continue;
+    llvm::MD5 FileHash;
+    FileHash.update(Buffer->getBuffer());
+    llvm::MD5::MD5Result FileResult;
+    FileHash.final(FileResult);
+    SmallString<32> Digest;
+    llvm::MD5::stringifyResult(FileResult, Digest);
+    Digests.push_back(Digest.str());
+  }
+  std::sort(Digests.begin(), Digests.end());
+
+  llvm::MD5 Hash;
+  Hash.update(StringRef(Bytes.data(), Bytes.size()));
+  for (const std::string &Digest : Digests)
+    Hash.update(Digest);
+  llvm::MD5::MD5Result Result;
+  Hash.final(Result);
+
+  ASTFileSignature S = llvm::support::endian::read32le(&Result[0]);
+  return S ? S : 1;
+}
+
 /// \brief Write the control block.
 uint64_t ASTWriter::WriteControlBlock(Preprocessor &PP,
                                       ASTContext &Context,
@@ -1319,6 +1356,9 @@ uint64_t ASTWriter::WriteControlBlock(Preprocessor &PP,
                                       const std::string &OutputFile) {
   ASTFileSignature Signature = 0;
 
+  const HeaderSearchOptions &HSOpts =
+      PP.getHeaderSearchInfo().getHeaderSearchOpts();
+
   using namespace llvm;
   Stream.EnterSubblock(CONTROL_BLOCK_ID, 5);
   RecordData Record;
@@ -1350,7 +1390,18 @@ uint64_t ASTWriter::WriteControlBlock(Preprocessor &PP,
     // duplicate module builds don't collide in the cache as their output order
     // is non-deterministic.
     // FIXME: Remove this when output is deterministic.
-    if (Context.getLangOpts().ImplicitModules) {
+    if (Context.getLangOpts().ImplicitModules && HSOpts.ReproducibleASTFiles) {
+      // Reproducible module files are signed with a hash of their contents,
+      // so differing duplicate builds still get different signatures. Write
+      // a placeholder and fill it in once the whole file has been written.
+      auto Abbrev = std::make_shared<BitCodeAbbrev>();
+      Abbrev->Add(BitCodeAbbrevOp(SIGNATURE));
+      Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Fixed, 32));
+      unsigned AbbrevCode = Stream.EmitAbbrev(std::move(Abbrev));
+      RecordData::value_type Record[] = {SIGNATURE, 0};
+      Stream.EmitRecordWithAbbrev(AbbrevCode, Record);
+      SignatureOffset = Stream.GetCurrentBitNo() - 32;
+    } else if (Context.getLangOpts().ImplicitModules) {
       Signature = getSignature();
       RecordData::value_type Record[] = {Signature};
       Stream.EmitRecord(SIGNATURE, Record);
@@ -1372,10 +1423,22 @@ uint64_t ASTWriter::WriteControlBlock(Preprocessor &PP,
     // If the home of the module is the current working directory, then we
     // want to pick up the cwd of the build process loading the module, not
     // our cwd, when we load this module.
-    if (!PP.getHeaderSearchInfo()
-             .getHeaderSearchOpts()
-             .ModuleMapFileHomeIsCwd ||
+    if (!HSOpts.ModuleMapFileHomeIsCwd ||
         WritingModule->Directory->getName() != StringRef(".")) {
+      // If requested, write the module directory relative to the path root
+      // so that the module file does not depend on where it was built.
+      StringRef ModuleDir = BaseDir;
+      SmallString<128> PathRoot(HSOpts.ASTFilePathRoot);
+      if (!PathRoot.empty()) {
+        cleanPathForOutput(Context.getSourceManager().getFileManager(),
+                           PathRoot);
+        if (BaseDir == PathRoot)
+          ModuleDir = ".";
+        else
+          ModuleDir =
+              adjustFilenameForRelocatableAST(BaseDir.c_str(), PathRoot);
+      }
+
       // Module directory.
       auto Abbrev = std::make_shared<BitCodeAbbrev>();
       Abbrev->Add(BitCodeAbbrevOp(MODULE_DIRECTORY));
@@ -1383,7 +1446,7 @@ uint64_t ASTWriter::WriteControlBlock(Preprocessor &PP,
       unsigned AbbrevCode = Stream.EmitAbbrev(std::move(Abbrev));
 
       RecordData::value_type Record[] = {MODULE_DIRECTORY};
-      Stream.EmitRecordWithBlob(AbbrevCode, Record, BaseDir);
+      Stream.EmitRecordWithBlob(AbbrevCode, Record, ModuleDir);
     }
 
     // Write out all other paths relative to the base directory if possible.
@@ -1604,7 +1667,8 @@ uint64_t ASTWriter::WriteControlBlock(Preprocessor &PP,
   Stream.EmitRecord(ORIGINAL_FILE_ID, Record);
 
   // Original PCH directory
-  if (!OutputFile.empty() && OutputFile != "-") {
+  if (!OutputFile.empty() && OutputFile != "-" &&
+      !HSOpts.ReproducibleASTFiles) {
     auto Abbrev = std::make_shared<BitCodeAbbrev>();
     Abbrev->Add(BitCodeAbbrevOp(ORIGINAL_PCH_DIR));
     Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Blob)); // File name
@@ -1619,9 +1683,7 @@ uint64_t ASTWriter::WriteControlBlock(Preprocessor &PP,
     Stream.EmitRecordWithBlob(AbbrevCode, Record, origDir);
   }
 
-  WriteInputFiles(Context.SourceMgr,
-                  PP.getHeaderSearchInfo().getHeaderSearchOpts(),
-                  PP.getLangOpts().Modules);
+  WriteInputFiles(Context.SourceMgr, HSOpts, PP.getLangOpts().Modules);
   Stream.ExitBlock();
   return Signature;
 }
@@ -4223,9 +4285,10 @@ void ASTWriter::SetSelectorOffset(Selector Sel, uint32_t Offset) {
 }
 
 ASTWriter::ASTWriter(llvm::BitstreamWriter &Stream,
+                     SmallVectorImpl<char> &Buffer,
                      ArrayRef<std::shared_ptr<ModuleFileExtension>> Extensions,
                      bool IncludeTimestamps)
-    : Stream(Stream), IncludeTimestamps(IncludeTimestamps) {
+    : Stream(Stream), Buffer(Buffer), IncludeTimestamps(IncludeTimestamps) {
   for (const auto &Ext : Extensions) {
     if (auto Writer = Ext->createExtensionWriter(*this))
       ModuleFileExtensionWriters.push_back(std::move(Writer));
@@ -4265,6 +4328,14 @@ uint64_t ASTWriter::WriteAST(Sema &SemaRef, const std::string &OutputFile,
   this->WritingModule = WritingModule;
   ASTFileSignature Signature =
       WriteASTCore(SemaRef, isysroot, OutputFile, WritingModule);
+
+  // Now that the whole file is written, fill in a signature derived from it.
+  if (SignatureOffset) {
+    Signature = getContentSignature(Buffer, Context->getSourceManager());
+    Stream.BackpatchWord(SignatureOffset, Signature);
+    SignatureOffset = 0;
+  }
+
   Context = nullptr;
   PP = nullptr;
   this->WritingModule = nullptr;
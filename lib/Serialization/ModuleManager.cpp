@@ -17,8 +17,12 @@
 #include "clang/Lex/ModuleMap.h"
 #include "clang/Serialization/GlobalModuleIndex.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Mutex.h"
+#include "llvm/Support/MutexGuard.h"
 #include "llvm/Support/Path.h"
+#include <map>
 #include <system_error>
+#include <tuple>
 
 #ifndef NDEBUG
 #include "llvm/Support/GraphWriter.h"
@@ -52,6 +56,87 @@ ModuleManager::lookupBuffer(StringRef Name) {
   return std::move(InMemoryBuffers[Entry]);
 }
 
+namespace {
+/// \brief Identifies the contents of a module file: the file itself, along
+/// with the size and modification time it had when it was read.
+///
+/// The unique IDs of virtual files are unique within the process, so files
+/// from any file system can share this key space.
+typedef std::tuple<llvm::sys::fs::UniqueID, uint64_t, llvm::sys::TimePoint<>>
+    SharedBufferKey;
+typedef std::map<SharedBufferKey, std::weak_ptr<llvm::MemoryBuffer>>
+    SharedBufferMap;
+} // end anonymous namespace
+
+static llvm::sys::Mutex &getSharedBufferMutex() {
+  static llvm::sys::Mutex M;
+  return M;
+}
+
+/// \brief The buffers of the module files loaded by any ModuleManager in this
+/// process. Guarded by \c getSharedBufferMutex().
+static SharedBufferMap &getSharedBufferMap() {
+  static SharedBufferMap M;
+  return M;
+}
+
+/// \brief Retrieve the contents of the module file \p Entry, sharing the
+/// buffer with every other ModuleManager in the process that has the same
+/// file loaded.
+///
+/// A buffer is not guaranteed to keep its file open, so once a file is
+/// deleted its unique ID can be reused by an unrelated file. The file is
+/// therefore stat'ed afresh on every lookup, and a buffer is only reused if
+/// the file still has the unique ID, size and (full precision) modification
+/// time it had when the buffer was read.
+static llvm::ErrorOr<std::shared_ptr<llvm::MemoryBuffer>>
+getSharedModuleBuffer(FileManager &FileMgr, const FileEntry *Entry) {
+  vfs::Status Status;
+  bool CanShare = !FileMgr.getNoncachedStatValue(Entry->getName(), Status) &&
+                  Status.getUniqueID() == Entry->getUniqueID();
+  SharedBufferKey Key(Status.getUniqueID(), Status.getSize(),
+                      Status.getLastModificationTime());
+  if (CanShare) {
+    llvm::MutexGuard Guard(getSharedBufferMutex());
+    auto Known = getSharedBufferMap().find(Key);
+    if (Known != getSharedBufferMap().end())
+      if (std::shared_ptr<llvm::MemoryBuffer> Buffer = Known->second.lock())
+        return Buffer;
+  }
+
+  // Leave the FileEntry open so if it gets read again by another
+  // ModuleManager it must be the same underlying file.
+  // FIXME: Because FileManager::getFile() doesn't guarantee that it will
+  // give us an open file, this may not be 100% reliable.
+  auto Buf = FileMgr.getBufferForFile(Entry,
+                                      /*IsVolatile=*/false,
+                                      /*ShouldClose=*/false);
+  if (!Buf)
+    return Buf.getError();
+
+  std::shared_ptr<llvm::MemoryBuffer> Buffer = std::move(*Buf);
+  if (!CanShare)
+    return Buffer;
+
+  llvm::MutexGuard Guard(getSharedBufferMutex());
+  SharedBufferMap &Buffers = getSharedBufferMap();
+
+  // Another ModuleManager may have loaded the same file in the meantime.
+  std::weak_ptr<llvm::MemoryBuffer> &Slot = Buffers[Key];
+  if (std::shared_ptr<llvm::MemoryBuffer> Existing = Slot.lock())
+    return Existing;
+  Slot = Buffer;
+
+  // Forget about buffers that are no longer in use.
+  for (auto I = Buffers.begin(), E = Buffers.end(); I != E;) {
+    if (I->second.expired())
+      I = Buffers.erase(I);
+    else
+      ++I;
+  }
+  return Buffer;
+}
+
 ModuleManager::AddModuleResult
 ModuleManager::addModule(StringRef FileName, ModuleKind Type,
                          SourceLocation ImportLoc, ModuleFile *ImportedBy,
@@ -111,18 +196,16 @@ ModuleManager::addModule(StringRef FileName, ModuleKind Type,
       ModuleEntry->Buffer = std::move(Buffer);
     } else {
       // Open the AST file.
-      llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> Buf(
+      llvm::ErrorOr<std::shared_ptr<llvm::MemoryBuffer>> Buf(
           (std::error_code()));
       if (FileName == "-") {
-        Buf = llvm::MemoryBuffer::getSTDIN();
+        auto StdIn = llvm::MemoryBuffer::getSTDIN();
+        if (StdIn)
+          Buf = std::shared_ptr<llvm::MemoryBuffer>(std::move(*StdIn));
+        else
+          Buf = StdIn.getError();
       } else {
-        // Leave the FileEntry open so if it gets read again by another
-        // ModuleManager it must be the same underlying file.
-        // FIXME: Because FileManager::getFile() doesn't guarantee that it will
-        // give us an open file, this may not be 100% reliable.
-        Buf = FileMgr.getBufferForFile(ModuleEntry->File,
-                                       /*IsVolatile=*/false,
-                                       /*ShouldClose=*/false);
+        Buf = getSharedModuleBuffer(FileMgr, ModuleEntry->File);
       }
 
       if (!Buf) {
@@ -31,6 +31,63 @@ namespace serialization {
 
 class ModuleFile;
 
+/// \brief A Bloom filter over the key hashes of a single on-disk hash table.
+///
+/// Each table in a MultiOnDiskHashTable carries one of these, so that a lookup
+/// of a name that the table does not contain can usually be answered without
+/// touching the table's buckets. With long chains of module files most tables
+/// do not contain most names, and this avoids a page fault per table.
+class OnDiskHashTableFilter {
+  /// \brief The number of filter bits allocated for each key.
+  static const unsigned BitsPerKey = 10;
+  /// \brief The number of bits set for each key.
+  static const unsigned NumProbes = 3;
+
+  const unsigned char *Words;
+  uint32_t NumWords;
+
+public:
+  OnDiskHashTableFilter() : Words(nullptr), NumWords(0) {}
+  OnDiskHashTableFilter(const unsigned char *Words, uint32_t NumWords)
+      : Words(Words), NumWords(NumWords) {}
+
+  /// \brief Compute the number of 32-bit filter words to emit for a table
+  /// with \p NumKeys keys.
+  static uint32_t getNumWords(unsigned NumKeys) {
+    return (uint64_t(NumKeys) * BitsPerKey + 31) / 32;
+  }
+
+  /// \brief Call \p Fn with the index of every filter bit that corresponds to
+  /// the key hash \p Hash, in a filter of \p NumBits bits.
+  template<typename Fn>
+  static void forEachBit(uint32_t Hash, uint32_t NumBits, Fn F) {
+    // Derive the probe sequence from the single 32-bit key hash by double
+    // hashing.
+    uint32_t Delta = (Hash >> 17) | (Hash << 15);
+    for (unsigned I = 0; I != NumProbes; ++I) {
+      F(Hash % NumBits);
+      Hash += Delta;
+    }
+  }
+
+  /// \brief Determine whether a key with hash \p Hash may be present in the
+  /// table. A table written without a filter may contain any key.
+  bool mayContain(uint32_t Hash) const {
+    using namespace llvm::support;
+    if (!NumWords)
+      return true;
+
+    bool Result = true;
+    forEachBit(Hash, NumWords * 32, [&](uint32_t Bit) {
+      uint32_t Word =
+          endian::read<uint32_t, little, unaligned>(Words + 4 * (Bit / 32));
+      if (!(Word & (1u << (Bit % 32))))
+        Result = false;
+    });
+    return Result;
+  }
+};
+
 /// \brief A collection of on-disk hash tables, merged when relevant for performance.
 template<typename Info> class MultiOnDiskHashTable {
 public:
@@ -51,12 +108,14 @@ private:
     typedef llvm::OnDiskIterableChainedHashTable<Info> HashTable;
 
     file_type File;
+    OnDiskHashTableFilter Filter;
     HashTable Table;
 
-    OnDiskTable(file_type File, unsigned NumBuckets, unsigned NumEntries,
+    OnDiskTable(file_type File, OnDiskHashTableFilter Filter,
+                unsigned NumBuckets, unsigned NumEntries,
                 storage_type Buckets, storage_type Payload, storage_type Base,
                 const Info &InfoObj)
-        : File(File),
+        : File(File), Filter(Filter),
           Table(NumBuckets, NumEntries, Buckets, Payload, Base, InfoObj) {}
   };
 
@@ -200,13 +259,18 @@ public:
     PendingOverrides.insert(PendingOverrides.end(), OverriddenFiles.begin(),
                             OverriddenFiles.end());
 
+    // Read the key filter.
+    uint32_t NumFilterWords = endian::readNext<uint32_t, little, unaligned>(Ptr);
+    OnDiskHashTableFilter Filter(Ptr, NumFilterWords);
+    Ptr += 4 * NumFilterWords;
+
     // Read the OnDiskChainedHashTable header.
     storage_type Buckets = Data + BucketOffset;
     auto NumBucketsAndEntries =
         OnDiskTable::HashTable::readNumBucketsAndEntries(Buckets);
 
     // Register the table.
-    Table NewTable = new OnDiskTable(File, NumBucketsAndEntries.first,
+    Table NewTable = new OnDiskTable(File, Filter, NumBucketsAndEntries.first,
                                      NumBucketsAndEntries.second,
                                      Buckets, Ptr, Data, std::move(InfoObj));
     Tables.push_back(NewTable.getOpaqueValue());
@@ -234,6 +298,9 @@ public:
     data_type_builder ResultBuilder(Result);
 
     for (auto *ODT : tables()) {
+      if (!ODT->Filter.mayContain(KeyHash))
+        continue;
+
       auto &HT = ODT->Table;
       auto It = HT.find_hashed(Key, KeyHash);
       if (It != HT.end())
@@ -283,11 +350,31 @@ class MultiOnDiskHashTableGenerator {
 
   Generator Gen;
 
+  /// \brief The hashes of all keys inserted into the generator, used to build
+  /// the key filter.
+  std::vector<uint32_t> KeyHashes;
+
+  void emitFilter(llvm::raw_ostream &OutStream) {
+    using namespace llvm::support;
+    uint32_t NumWords = OnDiskHashTableFilter::getNumWords(KeyHashes.size());
+    std::vector<uint32_t> Words(NumWords);
+    for (uint32_t Hash : KeyHashes)
+      OnDiskHashTableFilter::forEachBit(Hash, NumWords * 32, [&](uint32_t Bit) {
+        Words[Bit / 32] |= 1u << (Bit % 32);
+      });
+
+    endian::Writer<little> Writer(OutStream);
+    Writer.write<uint32_t>(NumWords);
+    for (uint32_t Word : Words)
+      Writer.write<uint32_t>(Word);
+  }
+
 public:
   MultiOnDiskHashTableGenerator() : Gen() {}
 
   void insert(typename WriterInfo::key_type_ref Key,
               typename WriterInfo::data_type_ref Data, WriterInfo &Info) {
+    KeyHashes.push_back(Info.ComputeHash(Key));
     Gen.insert(Key, Data, Info);
   }
 
@@ -312,13 +399,16 @@ public:
         // Add all merged entries from Base to the generator.
         for (auto &KV : Merged->Data) {
           if (!Gen.contains(KV.first, Info))
-            Gen.insert(KV.first, Info.ImportData(KV.second), Info);
+            insert(KV.first, Info.ImportData(KV.second), Info);
         }
       } else {
         Writer.write<uint32_t>(0);
       }
     }
 
+    // Write the filter over every key in the table.
+    emitFilter(OutStream);
+
     // Write the table itself.
     uint32_t BucketOffset = Gen.Emit(OutStream, Info);
 
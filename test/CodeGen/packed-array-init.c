@@ -0,0 +1,29 @@
+// RUN: %clang_cc1 -triple x86_64-unknown-unknown -emit-llvm -o - %s | FileCheck %s
+
+// Arrays of numeric literals are emitted as packed data arrays. Check that
+// the values match those of the usual conversions.
+
+// CHECK: @u8 = global [6 x i8] c"\01\FF\80a\00\00"
+unsigned char u8[6] = {1, -1, 128, 'a'};
+
+// CHECK: @s16 = global [4 x i16] [i16 -2, i16 300, i16 -32768, i16 0]
+short s16[] = {-2, 300, 32768, [3] = 0};
+
+// CHECK: @u32 = global [5 x i32] [i32 1, i32 0, i32 -1, i32 7, i32 0]
+unsigned u32[5] = {1, [2] = -1u, 7};
+
+// CHECK: @s64 = global [3 x i64] [i64 -1, i64 4294967296, i64 -9223372036854775808]
+long long s64[] = {-1, 4294967296, -9223372036854775807LL - 1};
+
+// CHECK: @f = global [4 x float] [float 1.000000e+00, float -2.000000e+00, float 5.000000e-01, float 0x3FB99999A0000000]
+float f[] = {1, -2.0, 0.5f, 0.1};
+
+// CHECK: @d = global [3 x double] [double -3.000000e+00, double 2.500000e-01, double 0.000000e+00]
+double d[3] = {-3, .25};
+
+// CHECK: @grid = global [3 x [2 x i32]] {{\[}}[2 x i32] [i32 1, i32 2], [2 x i32] [i32 3, i32 0], [2 x i32] zeroinitializer]
+int grid[3][2] = {{1, 2}, {3}};
+
+// Elements that aren't literals still go through constant evaluation.
+// CHECK: @mixed = global [2 x i32] [i32 3, i32 4]
+int mixed[] = {1 + 2, 4};
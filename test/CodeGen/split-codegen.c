@@ -0,0 +1,63 @@
+// REQUIRES: x86-registered-target
+// RUN: %clang_cc1 -triple x86_64-unknown-linux-gnu -emit-obj %s -o %t.0.o \
+// RUN:   -split-codegen-output %t.1.o
+// RUN: llvm-nm -defined-only %t.0.o %t.1.o | FileCheck %s
+
+// Every definition is emitted by one of the partitions, and the static
+// helper stays local to the partition of its user.
+
+// CHECK-DAG: T big
+// CHECK-DAG: t helper
+// CHECK-DAG: T other
+// CHECK-DAG: T user
+// CHECK-DAG: D counter
+
+// Each partition describes its own functions, but the global variable is
+// described only by the partition that defines it.
+// RUN: %clang_cc1 -triple x86_64-unknown-linux-gnu -emit-obj %s -o %t.g0.o \
+// RUN:   -split-codegen-output %t.g1.o -debug-info-kind=limited
+// RUN: llvm-dwarfdump -debug-dump=info %t.g0.o %t.g1.o \
+// RUN:   | FileCheck -check-prefix=DEBUG %s
+// RUN: llvm-dwarfdump -debug-dump=info %t.g0.o %t.g1.o \
+// RUN:   | grep -c DW_TAG_compile_unit | FileCheck -check-prefix=UNITS %s
+
+// DEBUG: DW_AT_name {{.*}}"counter"
+// DEBUG-NOT: DW_TAG
+// DEBUG: DW_AT_location
+// DEBUG-NOT: DW_AT_name {{.*}}"counter"
+// UNITS: 2
+
+// With split debug info, each partition names a split debug info file of its
+// own.
+// RUN: %clang_cc1 -triple x86_64-unknown-linux-gnu -emit-obj %s -o %t.s0.o \
+// RUN:   -split-codegen-output %t.s1.o -debug-info-kind=limited \
+// RUN:   -backend-option -split-dwarf=Enable -split-dwarf-file %t.s0.dwo \
+// RUN:   -split-codegen-dwarf-file %t.s1.dwo
+// RUN: llvm-dwarfdump -debug-dump=info %t.s0.o \
+// RUN:   | FileCheck -check-prefix=DWO0 %s
+// RUN: llvm-dwarfdump -debug-dump=info %t.s1.o \
+// RUN:   | FileCheck -check-prefix=DWO1 %s
+
+// DWO0: DW_AT_GNU_dwo_name {{.*}}.s0.dwo"
+// DWO1: DW_AT_GNU_dwo_name {{.*}}.s1.dwo"
+
+int counter = 1;
+
+int big(int n) {
+  int a = 0, b = 1, c = 2, d = 3;
+  for (int i = 0; i < n; ++i) {
+    a += b * i;
+    b ^= c + i;
+    c -= d * a;
+    d += a ^ b;
+    a = a * 7 + c;
+    b = b * 11 + d;
+  }
+  return a + b + c + d;
+}
+
+static int helper(int x) { return x * 3; }
+
+int user(int x) { return helper(x) + 1; }
+
+int other(int x) { return x - counter; }
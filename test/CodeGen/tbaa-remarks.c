@@ -0,0 +1,39 @@
+// RUN: %clang_cc1 -triple x86_64-unknown-unknown -O1 -emit-llvm-only -Rtbaa -verify %s
+// RUN: %clang_cc1 -triple x86_64-unknown-unknown -O1 -emit-llvm-only -Rtbaa -fstrict-vector-aliasing -DSTRICT -verify %s
+
+typedef float v4f __attribute__((vector_size(16)));
+typedef int aliasing_int __attribute__((may_alias));
+struct __attribute__((may_alias)) MA { int x; };
+enum E { E0, E1 };
+
+v4f load_vector(v4f *p) {
+  return *p;
+#ifndef STRICT
+  // expected-remark@-2 {{load from 'v4f' (vector of 4 'float' values) may alias any type because vector types are not type-based alias analyzed without -fstrict-vector-aliasing}}
+#endif
+}
+
+void store_vector(v4f *p, v4f v) {
+  *p = v;
+#ifndef STRICT
+  // expected-remark@-2 {{store to 'v4f' (vector of 4 'float' values) may alias any type}}
+#endif
+}
+
+int load_may_alias(aliasing_int *p) {
+  return *p; // expected-remark {{load from 'aliasing_int' (aka 'int') may alias any type because the type has the 'may_alias' attribute}}
+}
+
+int load_may_alias_member(struct MA *p) {
+  return p->x; // expected-remark {{load from 'int' may alias any type because it is a member of a 'may_alias' record}}
+}
+
+void store_enum(enum E *p) {
+  *p = E1; // expected-remark {{store to 'enum E' may alias any type because enumeration types in C and enumeration types without linkage are not type-based alias analyzed}}
+}
+
+// Character types, types with a TBAA type of their own, and local variables
+// are not reported.
+char load_char(char *p) { return *p; }
+float load_float(float *p) { return *p; }
+v4f load_local(v4f v) { return v; }
@@ -0,0 +1,65 @@
+// RUN: %clang_cc1 -triple x86_64-unknown-unknown -O1 -disable-llvm-passes -emit-llvm -o - %s | FileCheck %s --check-prefix=CHECK --check-prefix=DEFAULT
+// RUN: %clang_cc1 -triple x86_64-unknown-unknown -O1 -disable-llvm-passes -fstrict-vector-aliasing -emit-llvm -o - %s | FileCheck %s --check-prefix=CHECK --check-prefix=STRICT
+//
+// Check the TBAA types of vectors, and of unions whose members all have the
+// same type.
+
+typedef float v4f __attribute__((vector_size(16)));
+typedef unsigned v4u __attribute__((vector_size(16)));
+typedef char v16c __attribute__((vector_size(16)));
+typedef v4f v4f_may_alias __attribute__((may_alias));
+
+v4f load_v4f(v4f *p) { return *p; }
+// CHECK-LABEL: @load_v4f(
+// CHECK: load <4 x float>, <4 x float>* %{{.*}}, !tbaa [[TAG_V4F:!.*]]
+
+v4u load_v4u(v4u *p) { return *p; }
+// CHECK-LABEL: @load_v4u(
+// CHECK: load <4 x i32>, <4 x i32>* %{{.*}}, !tbaa [[TAG_V4U:!.*]]
+
+v16c load_v16c(v16c *p) { return *p; }
+// CHECK-LABEL: @load_v16c(
+// CHECK: load <16 x i8>, <16 x i8>* %{{.*}}, !tbaa [[TAG_CHAR:!.*]]
+
+v4f load_v4f_may_alias(v4f_may_alias *p) { return *p; }
+// CHECK-LABEL: @load_v4f_may_alias(
+// CHECK: load <4 x float>, <4 x float>* %{{.*}}, !tbaa [[TAG_CHAR]]
+
+struct S {
+  int n;
+  union { v4f v; float f[4]; } u;
+};
+struct T {
+  int n;
+  union { float a; float b[2]; } u;
+};
+struct M {
+  int n;
+  union { int i; float f; } u;
+};
+
+void store_n(struct S *s, struct T *t, struct M *m) {
+  s->n = 1;
+  t->n = 2;
+  m->n = 3;
+}
+// CHECK-LABEL: @store_n(
+// CHECK: store i32 1, i32* %{{.*}}, !tbaa [[TAG_S_N:!.*]]
+// CHECK: store i32 2, i32* %{{.*}}, !tbaa [[TAG_T_N:!.*]]
+// CHECK: store i32 3, i32* %{{.*}}, !tbaa [[TAG_M_N:!.*]]
+
+// CHECK-DAG: [[CHAR:!.*]] = !{!"omnipotent char", !{{.*}}, i64 0}
+// CHECK-DAG: [[INT:!.*]] = !{!"int", [[CHAR]], i64 0}
+// CHECK-DAG: [[FLOAT:!.*]] = !{!"float", [[CHAR]], i64 0}
+// CHECK-DAG: [[TAG_CHAR]] = !{[[CHAR]], [[CHAR]], i64 0}
+// DEFAULT-DAG: [[TAG_V4F]] = !{[[CHAR]], [[CHAR]], i64 0}
+// DEFAULT-DAG: [[TAG_V4U]] = !{[[CHAR]], [[CHAR]], i64 0}
+// STRICT-DAG: [[TAG_V4F]] = !{[[FLOAT]], [[FLOAT]], i64 0}
+// STRICT-DAG: [[TAG_V4U]] = !{[[INT]], [[INT]], i64 0}
+// CHECK-DAG: [[TAG_S_N]] = !{[[S:!.*]], [[INT]], i64 0}
+// DEFAULT-DAG: [[S]] = !{!"S", [[INT]], i64 0, [[CHAR]], i64 16}
+// STRICT-DAG: [[S]] = !{!"S", [[INT]], i64 0, [[FLOAT]], i64 16}
+// CHECK-DAG: [[TAG_T_N]] = !{[[T:!.*]], [[INT]], i64 0}
+// CHECK-DAG: [[T]] = !{!"T", [[INT]], i64 0, [[FLOAT]], i64 4}
+// CHECK-DAG: [[TAG_M_N]] = !{[[M:!.*]], [[INT]], i64 0}
+// CHECK-DAG: [[M]] = !{!"M", [[INT]], i64 0, [[CHAR]], i64 4}
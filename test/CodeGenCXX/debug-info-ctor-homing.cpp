@@ -0,0 +1,57 @@
+// RUN: %clang_cc1 -triple x86_64-unknown-linux-gnu -debug-info-kind=limited -fuse-ctor-homing -emit-llvm %s -o - | FileCheck %s
+// RUN: %clang_cc1 -triple x86_64-unknown-linux-gnu -debug-info-kind=limited -emit-llvm %s -o - | FileCheck -check-prefix=NOHOMING %s
+
+// The constructor is not emitted here, so only a declaration is emitted.
+struct A {
+  A();
+  int i;
+};
+void useA() { A a; }
+// CHECK: !DICompositeType(tag: DW_TAG_structure_type, name: "A"
+// CHECK-SAME:             DIFlagFwdDecl
+// NOHOMING: !DICompositeType(tag: DW_TAG_structure_type, name: "A"
+// NOHOMING-NOT:             DIFlagFwdDecl
+// NOHOMING-SAME:            ){{$}}
+
+// The definition is emitted along with the constructor.
+struct B {
+  B();
+  int i;
+};
+B::B() : i(0) {}
+// CHECK: !DICompositeType(tag: DW_TAG_structure_type, name: "B"
+// CHECK-NOT:              DIFlagFwdDecl
+// CHECK-SAME:             ){{$}}
+
+// Aggregates can be created without calling a constructor.
+struct C {
+  int i;
+};
+void useC() { C c; }
+// CHECK: !DICompositeType(tag: DW_TAG_structure_type, name: "C"
+// CHECK-NOT:              DIFlagFwdDecl
+// CHECK-SAME:             ){{$}}
+
+// So can classes with constexpr constructors.
+struct D {
+  constexpr D(int i) : i(i) {}
+  D(const char *);
+  int i;
+};
+void useD() { D d(0); }
+// CHECK: !DICompositeType(tag: DW_TAG_structure_type, name: "D"
+// CHECK-NOT:              DIFlagFwdDecl
+// CHECK-SAME:             ){{$}}
+
+// Dynamic classes are emitted along with their vtable, not with their
+// constructors, even when a constructor is emitted here.
+struct E {
+  E() : i(0) {}
+  virtual void f();
+  int i;
+};
+void useE() { E e; }
+// CHECK: !DICompositeType(tag: DW_TAG_structure_type, name: "E"
+// CHECK-SAME:             DIFlagFwdDecl
+// NOHOMING: !DICompositeType(tag: DW_TAG_structure_type, name: "E"
+// NOHOMING-SAME:          DIFlagFwdDecl
@@ -0,0 +1,54 @@
+// RUN: %clang_cc1 -std=c++11 -triple x86_64-unknown-linux-gnu -ffree-function-bodies -emit-llvm -o %t.free.ll %s
+// RUN: FileCheck %s < %t.free.ll
+// RUN: %clang_cc1 -std=c++11 -triple x86_64-unknown-linux-gnu -emit-llvm -o %t.ll %s
+// RUN: diff %t.ll %t.free.ll
+// RUN: %clang_cc1 -std=c++11 -triple x86_64-unknown-linux-gnu -ffree-function-bodies -emit-llvm -o /dev/null -print-stats %s 2>&1 | FileCheck -check-prefix=STATS %s
+// RUN: %clang_cc1 -std=c++11 -triple x86_64-unknown-linux-gnu -emit-llvm -o /dev/null -print-stats %s 2>&1 | FileCheck -check-prefix=NOFREE %s
+
+// Releasing the bodies does not change the generated code.
+// STATS: {{[1-9][0-9]*}} function bodies released
+// NOFREE-NOT: function bodies released
+
+int g(int);
+static int h(int);
+inline int i(int);
+
+// CHECK-LABEL: define i32 @_Z1fi(
+// CHECK: call i32 @_Z1gi(
+// CHECK: add nsw i32 {{.*}}, 1
+int f(int x) { return g(x) + 1; }
+
+// CHECK-LABEL: define i32 @_Z4useHi(
+// CHECK: call i32 @_ZL1hi(
+int useH(int x) { return h(x); }
+
+// CHECK-LABEL: define i32 @_Z4useIi(
+// CHECK: call i32 @_Z1ii(
+int useI(int x) { return i(x); }
+
+// Local statics, local classes and lambdas keep the body alive.
+// CHECK-LABEL: define i32 @_Z10withStaticv(
+// CHECK: load i32, i32* @_ZZ10withStaticvE1n
+int withStatic() { static int n = g(0); return n; }
+
+// CHECK-LABEL: define i32 @_Z10withLambdav(
+int withLambda() { return [] { return 4; }(); }
+
+// CHECK-LABEL: define i32 @_Z9withLocalv(
+int withLocal() {
+  struct Local { int get() { return 6; } };
+  return Local().get();
+}
+
+struct S { virtual int v(); };
+// CHECK-LABEL: define i32 @_ZN1S1vEv(
+// CHECK: ret i32 5
+int S::v() { return 5; }
+
+// Inline functions are not released.
+// CHECK-DAG: define linkonce_odr i32 @_Z1ii(
+inline int i(int x) { return x - 1; }
+
+// Deferred static functions are released when they are emitted.
+// CHECK-DAG: define internal i32 @_ZL1hi(
+static int h(int x) { return x * 2; }
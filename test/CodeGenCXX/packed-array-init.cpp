@@ -0,0 +1,16 @@
+// RUN: %clang_cc1 -std=c++11 -triple x86_64-unknown-unknown -emit-llvm -o - %s | FileCheck %s
+
+// Constexpr tables of numeric literals are emitted as packed data arrays, and
+// their values are still available to constant expressions.
+
+// CHECK: @_ZL5table = internal constant [5 x i16] [i16 1, i16 -2, i16 3, i16 0, i16 0]
+constexpr short table[5] = {1, -2, 3};
+static_assert(table[1] == -2, "");
+static_assert(table[4] == 0, "");
+
+// CHECK: @_ZL4grid = internal constant [2 x [2 x double]] {{\[}}[2 x double] [double 5.000000e-01, double 2.000000e+00], [2 x double] zeroinitializer]
+constexpr double grid[2][2] = {{.5, 2}};
+static_assert(grid[0][1] == 2, "");
+
+const short *getTable() { return table; }
+const double *getGrid() { return grid[0]; }
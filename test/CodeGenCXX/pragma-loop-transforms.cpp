@@ -0,0 +1,78 @@
+// RUN: %clang_cc1 -triple x86_64-apple-darwin -std=c++11 -emit-llvm -o - %s | FileCheck %s
+
+void unroll_and_jam(int *List, int Length, int Width) {
+  // CHECK: define {{.*}} @_Z14unroll_and_jam
+#pragma clang loop unroll_and_jam(enable)
+  for (int i = 0; i < Length; i++) {
+    // CHECK: br label {{.*}}, !llvm.loop ![[LOOP_1:.*]]
+    for (int j = 0; j < Width; j++)
+      List[i] += j;
+  }
+
+#pragma clang loop unroll_and_jam_count(4)
+  for (int i = 0; i < Length; i++) {
+    // CHECK: br label {{.*}}, !llvm.loop ![[LOOP_2:.*]]
+    for (int j = 0; j < Width; j++)
+      List[i] += j;
+  }
+
+#pragma clang loop unroll_and_jam(disable)
+  for (int i = 0; i < Length; i++) {
+    // CHECK: br label {{.*}}, !llvm.loop ![[LOOP_3:.*]]
+    for (int j = 0; j < Width; j++)
+      List[i] += j;
+  }
+}
+
+void vectorize_predicate(int *List, int Length) {
+  // CHECK: define {{.*}} @_Z19vectorize_predicate
+#pragma clang loop vectorize(enable) vectorize_predicate(enable)
+  for (int i = 0; i < Length; i++) {
+    // CHECK: br label {{.*}}, !llvm.loop ![[LOOP_4:.*]]
+    List[i] = i * 2;
+  }
+
+#pragma clang loop vectorize_predicate(disable)
+  for (int i = 0; i < Length; i++) {
+    // CHECK: br label {{.*}}, !llvm.loop ![[LOOP_5:.*]]
+    List[i] = i * 2;
+  }
+}
+
+template <int II>
+void pipeline(int *List, int Length) {
+#pragma clang loop pipeline_initiation_interval(II)
+  for (int i = 0; i < Length; i++) {
+    List[i] = i * 2;
+  }
+}
+
+void pipeline_test(int *List, int Length) {
+  // CHECK: define {{.*}} @_Z13pipeline_test
+#pragma clang loop pipeline(disable)
+  for (int i = 0; i < Length; i++) {
+    // CHECK: br label {{.*}}, !llvm.loop ![[LOOP_6:.*]]
+    List[i] = i * 2;
+  }
+
+  pipeline<10>(List, Length);
+}
+
+// CHECK: define {{.*}} @_Z8pipelineILi10EEvPii
+// CHECK: br label {{.*}}, !llvm.loop ![[LOOP_7:.*]]
+
+// CHECK: ![[LOOP_1]] = distinct !{![[LOOP_1]], ![[UNROLL_AND_JAM_ENABLE:.*]]}
+// CHECK: ![[UNROLL_AND_JAM_ENABLE]] = !{!"llvm.loop.unroll_and_jam.enable"}
+// CHECK: ![[LOOP_2]] = distinct !{![[LOOP_2]], ![[UNROLL_AND_JAM_4:.*]]}
+// CHECK: ![[UNROLL_AND_JAM_4]] = !{!"llvm.loop.unroll_and_jam.count", i32 4}
+// CHECK: ![[LOOP_3]] = distinct !{![[LOOP_3]], ![[UNROLL_AND_JAM_DISABLE:.*]]}
+// CHECK: ![[UNROLL_AND_JAM_DISABLE]] = !{!"llvm.loop.unroll_and_jam.disable"}
+// CHECK: ![[LOOP_4]] = distinct !{![[LOOP_4]], ![[VECTORIZE_ENABLE:.*]], ![[PREDICATE_ENABLE:.*]]}
+// CHECK: ![[VECTORIZE_ENABLE]] = !{!"llvm.loop.vectorize.enable", i1 true}
+// CHECK: ![[PREDICATE_ENABLE]] = !{!"llvm.loop.vectorize.predicate.enable", i1 true}
+// CHECK: ![[LOOP_5]] = distinct !{![[LOOP_5]], ![[PREDICATE_DISABLE:.*]]}
+// CHECK: ![[PREDICATE_DISABLE]] = !{!"llvm.loop.vectorize.predicate.enable", i1 false}
+// CHECK: ![[LOOP_6]] = distinct !{![[LOOP_6]], ![[PIPELINE_DISABLE:.*]]}
+// CHECK: ![[PIPELINE_DISABLE]] = !{!"llvm.loop.pipeline.disable", i1 true}
+// CHECK: ![[LOOP_7]] = distinct !{![[LOOP_7]], ![[PIPELINE_II_10:.*]]}
+// CHECK: ![[PIPELINE_II_10]] = !{!"llvm.loop.pipeline.initiationinterval", i32 10}
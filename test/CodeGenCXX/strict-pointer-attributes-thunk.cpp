@@ -0,0 +1,30 @@
+// RUN: %clang_cc1 -triple x86_64-unknown-linux-gnu -fstrict-pointer-attributes -emit-llvm -o - %s | FileCheck %s
+
+// A this-adjusting thunk gets 'this' pointing to a base subobject in the
+// middle of the object, so only the function it calls can rely on 'this'.
+
+struct B1 {
+  virtual int f();
+  long b1;
+};
+
+struct B2 {
+  virtual int f();
+  virtual int g(int n, ...);
+  long b2;
+};
+
+struct D : B1, B2 {
+  int f();
+  int g(int n, ...);
+  int d;
+};
+
+// CHECK-LABEL: define i32 @_ZN1D1fEv(%struct.D* nonnull align 8 dereferenceable({{[0-9]+}}) %this)
+// CHECK-LABEL: define i32 @_ZThn16_N1D1fEv(%struct.D* %this)
+int D::f() { return d; }
+
+// Variadic thunks are clones of the function they adjust 'this' for.
+// CHECK-LABEL: define i32 @_ZN1D1gEiz(%struct.D* nonnull align 8 dereferenceable({{[0-9]+}}) %this, i32 %n, ...)
+// CHECK-LABEL: define i32 @_ZThn16_N1D1gEiz(%struct.D* %this, i32 %n, ...)
+int D::g(int n, ...) { return d + n; }
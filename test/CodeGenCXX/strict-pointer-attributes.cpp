@@ -0,0 +1,58 @@
+// RUN: %clang_cc1 -triple x86_64-unknown-linux-gnu -std=c++11 -fstrict-pointer-attributes -emit-llvm -o - %s | FileCheck %s
+// RUN: %clang_cc1 -triple x86_64-unknown-linux-gnu -std=c++11 -emit-llvm -o - %s | FileCheck %s --check-prefix=DEFAULT
+
+struct A {
+  int x;
+  double d;
+  int get() const;
+};
+
+struct C final {
+  int x;
+  double d;
+  char c;
+  int get() { return c; }
+};
+
+// CHECK-LABEL: define i32 @_ZNK1A3getEv(%struct.A* nonnull align 8 dereferenceable(16) %this)
+// DEFAULT-LABEL: define i32 @_ZNK1A3getEv(%struct.A* %this)
+int A::get() const { return x; }
+
+// CHECK-LABEL: define i32 @_Z5byrefRK1A(%struct.A* nonnull align 8 dereferenceable(16) %a)
+// DEFAULT-LABEL: define i32 @_Z5byrefRK1A(%struct.A* dereferenceable(16) %a)
+int byref(const A &a) { return a.x; }
+
+// CHECK-LABEL: define nonnull align 8 dereferenceable(16) %struct.A* @_Z3retP1A(%struct.A* %p)
+// DEFAULT-LABEL: define dereferenceable(16) %struct.A* @_Z3retP1A(%struct.A* %p)
+A &ret(A *p) { return *p; }
+
+// Characters are not marked with an alignment of one.
+// CHECK-LABEL: define void @_Z3chrRc(i8* nonnull dereferenceable(1) %c)
+// DEFAULT-LABEL: define void @_Z3chrRc(i8* dereferenceable(1) %c)
+void chr(char &c) {}
+
+// _Nonnull does not make null undefined, so null checks must be kept.
+// CHECK-LABEL: define i32 @_Z11nullabilityPi(i32* %p)
+// DEFAULT-LABEL: define i32 @_Z11nullabilityPi(i32* %p)
+int nullability(int * _Nonnull p) { return p ? *p : 0; }
+
+int nn_decl(int *p, int *q) __attribute__((nonnull(1)));
+int * _Nonnull nn_ret(int *p);
+
+// CHECK-LABEL: define i32 @_Z4callPiS_(
+// CHECK: call i32 @_Z7nn_declPiS_(i32* nonnull %{{.*}}, i32* %{{.*}})
+// CHECK: call i32* @_Z6nn_retPi(i32* %{{.*}})
+// DEFAULT-LABEL: define i32 @_Z4callPiS_(
+// DEFAULT: call i32 @_Z7nn_declPiS_(i32* %{{.*}}, i32* %{{.*}})
+// DEFAULT: call i32* @_Z6nn_retPi(i32* %{{.*}})
+// CHECK: declare i32 @_Z7nn_declPiS_(i32* nonnull, i32*)
+// CHECK: declare i32* @_Z6nn_retPi(i32*)
+// DEFAULT: declare i32 @_Z7nn_declPiS_(i32*, i32*)
+// DEFAULT: declare i32* @_Z6nn_retPi(i32*)
+int call(int *p, int *q) { return nn_decl(p, q) + *nn_ret(q); }
+
+// 'this' of a final class points to a complete object.
+// CHECK-LABEL: define i32 @_Z4useCR1C(
+// CHECK-LABEL: define linkonce_odr i32 @_ZN1C3getEv(%struct.C* nonnull align 8 dereferenceable(24) %this)
+// DEFAULT-LABEL: define linkonce_odr i32 @_ZN1C3getEv(%struct.C* %this)
+int useC(C &c) { return c.get(); }
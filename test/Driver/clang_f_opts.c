@@ -482,3 +482,13 @@
 // RUN: %clang -### -S -fno-strict-return %s 2>&1 | FileCheck -check-prefix=CHECK-NO-STRICT-RETURN %s
 // CHECK-STRICT-RETURN-NOT: "-fno-strict-return"
 // CHECK-NO-STRICT-RETURN: "-fno-strict-return"
+
+// RUN: %clang -### -S -fstrict-vector-aliasing %s 2>&1 | FileCheck -check-prefix=CHECK-STRICT-VECTOR-ALIASING %s
+// RUN: %clang -### -S -fstrict-vector-aliasing -fno-strict-vector-aliasing %s 2>&1 | FileCheck -check-prefix=CHECK-NO-STRICT-VECTOR-ALIASING %s
+// CHECK-STRICT-VECTOR-ALIASING: "-fstrict-vector-aliasing"
+// CHECK-NO-STRICT-VECTOR-ALIASING-NOT: "-fstrict-vector-aliasing"
+
+// RUN: %clang -### -S -fstrict-pointer-attributes %s 2>&1 | FileCheck -check-prefix=CHECK-STRICT-POINTER-ATTRIBUTES %s
+// RUN: %clang -### -S -fstrict-pointer-attributes -fno-strict-pointer-attributes %s 2>&1 | FileCheck -check-prefix=CHECK-NO-STRICT-POINTER-ATTRIBUTES %s
+// CHECK-STRICT-POINTER-ATTRIBUTES: "-fstrict-pointer-attributes"
+// CHECK-NO-STRICT-POINTER-ATTRIBUTES-NOT: "-fstrict-pointer-attributes"
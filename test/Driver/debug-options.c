@@ -148,6 +148,14 @@
 //
 // RUN: %clang -### -gmodules -gline-tables-only %s 2>&1 \
 // RUN:        | FileCheck -check-prefix=GLTO_ONLY %s
+
+// RUN: %clang -### -target x86_64-unknown-linux-gnu -g -fno-standalone-debug \
+// RUN:        -fuse-ctor-homing %s 2>&1 | FileCheck -check-prefix=CTORHOMING %s
+// RUN: %clang -### -target x86_64-unknown-linux-gnu -g -fstandalone-debug \
+// RUN:        -fuse-ctor-homing %s 2>&1 | FileCheck -check-prefix=NOCTORHOMING %s
+// RUN: %clang -### -target x86_64-unknown-linux-gnu -g -fno-standalone-debug \
+// RUN:        -fuse-ctor-homing -fno-use-ctor-homing %s 2>&1 \
+// RUN:        | FileCheck -check-prefix=NOCTORHOMING %s
 //
 // G: "-cc1"
 // G: "-debug-info-kind=limited"
@@ -209,6 +217,11 @@
 // NOCI-NOT: "-dwarf-column-info"
 //
 // GEXTREFS: "-dwarf-ext-refs" "-fmodule-format=obj" "-debug-info-kind={{standalone|limited}}"
+//
+// CTORHOMING: "-debug-info-kind=limited"
+// CTORHOMING: "-fuse-ctor-homing"
+//
+// NOCTORHOMING-NOT: "-fuse-ctor-homing"
 
 // RUN: not %clang -cc1 -debug-info-kind=watkind 2>&1 | FileCheck -check-prefix=BADSTRING1 %s
 // BADSTRING1: error: invalid value 'watkind' in '-debug-info-kind=watkind'
@@ -0,0 +1,48 @@
+// Check that -fsplit-codegen=N splits the object file into N partitions that
+// are combined by a relocatable link.
+//
+// RUN: %clang -target x86_64-unknown-linux-gnu -fsplit-codegen=3 -c %s \
+// RUN:   -o %t.o -### 2>&1 | FileCheck -check-prefix=CHECK-SPLIT %s
+// CHECK-SPLIT: "-cc1"
+// CHECK-SPLIT-SAME: "-o" "[[PART0:[^"]*-part0-[^"]*\.o]]"
+// CHECK-SPLIT-SAME: "-split-codegen-output" "[[PART1:[^"]*-part1-[^"]*\.o]]"
+// CHECK-SPLIT-SAME: "-split-codegen-output" "[[PART2:[^"]*-part2-[^"]*\.o]]"
+// CHECK-SPLIT: "-r" "-o" "{{.*}}.o" "[[PART0]]" "[[PART1]]" "[[PART2]]"
+
+// RUN: %clang -target x86_64-apple-macosx10.11 -fsplit-codegen=2 -c %s \
+// RUN:   -o %t.o -### 2>&1 | FileCheck -check-prefix=CHECK-MACHO %s
+// CHECK-MACHO: "-split-codegen-output"
+// CHECK-MACHO: "-r" "-o"
+
+// With split debug info, each partition gets a split debug info file of its
+// own, which is extracted before the partitions are combined.
+// RUN: %clang -target x86_64-unknown-linux-gnu -fsplit-codegen=2 -gsplit-dwarf \
+// RUN:   -c %s -o %t.o -### 2>&1 | FileCheck -check-prefix=CHECK-DWO %s
+// CHECK-DWO: "-cc1"
+// CHECK-DWO-SAME: "-o" "[[PART0:[^"]*-part0-[^"]*\.o]]"
+// CHECK-DWO-SAME: "-split-codegen-output" "[[PART1:[^"]*-part1-[^"]*\.o]]"
+// CHECK-DWO-SAME: "-split-dwarf-file" "[[DWO0:[^"]*split-codegen\.c\.tmp\.dwo]]"
+// CHECK-DWO-SAME: "-split-codegen-dwarf-file" "[[DWO1:[^"]*split-codegen\.c\.tmp\.part1\.dwo]]"
+// CHECK-DWO: objcopy{{[^"]*}}" "--extract-dwo" "[[PART0]]" "[[DWO0]]"
+// CHECK-DWO: objcopy{{[^"]*}}" "--strip-dwo" "[[PART0]]"
+// CHECK-DWO: objcopy{{[^"]*}}" "--extract-dwo" "[[PART1]]" "[[DWO1]]"
+// CHECK-DWO: objcopy{{[^"]*}}" "--strip-dwo" "[[PART1]]"
+// CHECK-DWO: "-r" "-o" "{{.*}}.o" "[[PART0]]" "[[PART1]]"
+// CHECK-DWO-NOT: objcopy
+
+// A single partition, or any output other than an object file, does not
+// split the code generation.
+// RUN: %clang -target x86_64-unknown-linux-gnu -fsplit-codegen=1 -c %s \
+// RUN:   -o %t.o -### 2>&1 | FileCheck -check-prefix=CHECK-NO-SPLIT %s
+// RUN: %clang -target x86_64-unknown-linux-gnu -fsplit-codegen=4 -S %s \
+// RUN:   -o %t.s -### 2>&1 | FileCheck -check-prefix=CHECK-NO-SPLIT %s
+// CHECK-NO-SPLIT-NOT: "-split-codegen-output"
+// CHECK-NO-SPLIT-NOT: "-r"
+
+// RUN: %clang -target x86_64-unknown-linux-gnu -fsplit-codegen=0 -c %s \
+// RUN:   -o %t.o -### 2>&1 | FileCheck -check-prefix=CHECK-INVALID %s
+// CHECK-INVALID: error: invalid integral value '0' in '-fsplit-codegen=0'
+
+// RUN: %clang -target x86_64-pc-windows-msvc -fsplit-codegen=2 -c %s \
+// RUN:   -o %t.o -### 2>&1 | FileCheck -check-prefix=CHECK-UNSUPPORTED %s
+// CHECK-UNSUPPORTED: error: unsupported option '-fsplit-codegen=2' for target 'x86_64-pc-windows-msvc{{.*}}'
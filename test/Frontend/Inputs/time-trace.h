@@ -0,0 +1 @@
+template <typename T> T square(T X) { return X * X; }
@@ -0,0 +1,31 @@
+// RUN: %clang_cc1 -fsyntax-only -ast-memory-stats-file=%t %s
+// RUN: FileCheck -input-file=%t %s
+
+// RUN: %clang_cc1 -fsyntax-only -ast-memory-stats-file=%S/doesnotexist/bla %s 2>&1 | FileCheck -check-prefix=OUTPUTFAIL %s
+// OUTPUTFAIL: warning: unable to open statistics output file '{{.*}}doesnotexist{{.}}bla': '{{[Nn]}}o such file or directory'
+
+template <typename T> T twice(T X) { return X + X; }
+
+struct S {
+  int Value;
+};
+
+int f() {
+  S A, B = A;
+  return twice(B.Value);
+}
+
+// CHECK: "allocator": {"bytes_reserved": {{[0-9]+}}, "bytes_allocated": {{[0-9]+}}, "side_table_bytes": {{[0-9]+}}},
+// CHECK: "decls": {
+// CHECK-DAG: "CXXRecord": {"count": {{[0-9]+}}, "bytes": {{[0-9]+}}}
+// CHECK-DAG: "FunctionTemplate": {"count": 1, "bytes": {{[0-9]+}}}
+// CHECK-DAG: "CXXConstructor": {"count": {{[0-9]+}}, "bytes": {{[0-9]+}}}
+// CHECK: "stmts": {
+// CHECK-DAG: "BinaryOperator": {"count": 2, "bytes": {{[0-9]+}}}
+// CHECK-DAG: "ReturnStmt": {"count": 3, "bytes": {{[0-9]+}}}
+// CHECK: "types": {
+// CHECK-DAG: "Builtin": {"count": {{[0-9]+}}, "bytes": {{[0-9]+}}}
+// CHECK-DAG: "Record": {"count": 1, "bytes": {{[0-9]+}}}
+// CHECK: "origins": {"parsed": {"count": {{[1-9][0-9]*}}, "bytes": {{[0-9]+}}}, "instantiated": {"count": {{[1-9][0-9]*}}, "bytes": {{[0-9]+}}}, "implicit": {"count": {{[1-9][0-9]*}}, "bytes": {{[0-9]+}}}, "deserialized": {"count": 0, "bytes": 0}},
+// CHECK: "files": {
+// CHECK: "{{.*}}ast-memory-stats.cpp": {"parsed": {{[1-9][0-9]*}}, "instantiated": {{[1-9][0-9]*}}, "implicit": {{[1-9][0-9]*}}, "deserialized": 0}
@@ -0,0 +1,10 @@
+// RUN: %clang_cc1 -load %llvmshlibdir/PrintFunctionNames%pluginext \
+// RUN:     -add-plugin print-fns -ffree-function-bodies -emit-llvm \
+// RUN:     -o /dev/null -print-stats %s 2>&1 | FileCheck %s
+// REQUIRES: plugins, examples
+
+// Plugins see the declarations after code has been generated for them, so
+// the function bodies are kept.
+// CHECK: top-level-decl: "f"
+// CHECK-NOT: function bodies released
+int f(int x) { return x + 1; }
@@ -0,0 +1,23 @@
+// RUN: rm -rf %t && mkdir %t
+// RUN: %clang_cc1 -triple x86_64-unknown-unknown -std=c++11 -ftime-trace \
+// RUN:   -ftime-trace-granularity=0 -emit-llvm -o %t/time-trace.ll %s
+// RUN: FileCheck %s < %t/time-trace.json
+
+// CHECK: {"traceEvents":[
+// CHECK-DAG: "name":"Source","args":{"detail":"{{.*}}time-trace.h"}
+// CHECK-DAG: "name":"ParseFunctionDefinition","args":{"detail":"use"}
+// CHECK-DAG: "name":"PerformPendingInstantiations"
+// CHECK-DAG: "name":"InstantiateFunction","args":{"detail":"square<int>"}
+// CHECK-DAG: "name":"EvaluateAsInitializer","args":{"detail":"Answer"}
+// CHECK-DAG: "name":"CodeGen Function","args":{"detail":"use"}
+// CHECK-DAG: "name":"CodeGenPasses"
+// CHECK-DAG: "name":"ExecuteCompiler"
+// CHECK-DAG: "name":"Total InstantiateFunction","args":{"count":1,
+// CHECK-DAG: "name":"thread_name","args":{"name":"Source"}
+// CHECK: ]}
+
+#include "Inputs/time-trace.h"
+
+constexpr int Answer = 6 * 7;
+
+int use(int X) { return square(X) + Answer; }
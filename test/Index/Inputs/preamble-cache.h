@@ -0,0 +1 @@
+int preamble_cache_function(int);
@@ -0,0 +1,37 @@
+#include "preamble-cache.h"
+void f() {
+  
+}
+
+// REQUIRES: shell
+// RUN: rm -rf %t
+// RUN: env CINDEXTEST_EDITING=1 CINDEXTEST_CREATE_PREAMBLE_ON_FIRST_PARSE=1 LIBCLANG_TIMING=1 LIBCLANG_PREAMBLE_CACHE_PATH=%t c-index-test -code-completion-at=%s:3:3 %s -I %S/Inputs -o - 2>&1 | FileCheck -check-prefix=CHECK-CC1 -check-prefix=BUILD %s
+// RUN: ls %t | grep '\.pch$'
+// RUN: ls %t | grep '\.preamble$'
+
+// A second process adopts the preamble stored by the first one.
+// RUN: env CINDEXTEST_EDITING=1 CINDEXTEST_CREATE_PREAMBLE_ON_FIRST_PARSE=1 LIBCLANG_TIMING=1 LIBCLANG_PREAMBLE_CACHE_PATH=%t c-index-test -code-completion-at=%s:3:3 %s -I %S/Inputs -o - 2>&1 | FileCheck -check-prefix=CHECK-CC1 -check-prefix=CACHED %s
+
+// Changing a header the preamble depends on invalidates the stored preamble.
+// RUN: cp %S/Inputs/preamble-cache.h %t/preamble-cache.h
+// RUN: env CINDEXTEST_EDITING=1 CINDEXTEST_CREATE_PREAMBLE_ON_FIRST_PARSE=1 LIBCLANG_TIMING=1 LIBCLANG_PREAMBLE_CACHE_PATH=%t c-index-test -code-completion-at=%s:3:3 %s -I %t -o - 2>&1 | FileCheck -check-prefix=CHECK-CC1 -check-prefix=BUILD %s
+// RUN: touch -m -t 201101010000 %t/preamble-cache.h
+// RUN: env CINDEXTEST_EDITING=1 CINDEXTEST_CREATE_PREAMBLE_ON_FIRST_PARSE=1 LIBCLANG_TIMING=1 LIBCLANG_PREAMBLE_CACHE_PATH=%t c-index-test -code-completion-at=%s:3:3 %s -I %t -o - 2>&1 | FileCheck -check-prefix=CHECK-CC1 -check-prefix=BUILD %s
+
+// Storing a preamble removes the stored preambles that were unused for a month.
+// RUN: rm -rf %t.prune
+// RUN: env CINDEXTEST_EDITING=1 CINDEXTEST_CREATE_PREAMBLE_ON_FIRST_PARSE=1 LIBCLANG_PREAMBLE_CACHE_PATH=%t.prune c-index-test -code-completion-at=%s:3:3 %s -I %S/Inputs -o - | FileCheck -check-prefix=CHECK-CC1 %s
+// RUN: ls %t.prune | count 3
+// RUN: touch -a -t 201101010000 %t.prune/*.pch %t.prune/*.preamble
+// RUN: touch -m -t 201101010000 %t.prune/preambles.timestamp
+// RUN: env CINDEXTEST_EDITING=1 CINDEXTEST_CREATE_PREAMBLE_ON_FIRST_PARSE=1 LIBCLANG_PREAMBLE_CACHE_PATH=%t.prune c-index-test -code-completion-at=%s:3:3 %s -I %S/Inputs -DOTHER_PREAMBLE -o - | FileCheck -check-prefix=CHECK-CC1 %s
+// RUN: ls %t.prune | count 3
+
+// BUILD: Precompiling preamble
+// BUILD: Parsing
+
+// CACHED-NOT: Precompiling preamble
+// CACHED: Parsing
+// CACHED-NOT: Precompiling preamble
+
+// CHECK-CC1: FunctionDecl:{ResultType int}{TypedText preamble_cache_function}{LeftParen (}{Placeholder int}{RightParen )} (50)
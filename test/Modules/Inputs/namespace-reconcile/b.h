@@ -0,0 +1,5 @@
+namespace N {
+  long a(int);
+  int b();
+  int local();
+}
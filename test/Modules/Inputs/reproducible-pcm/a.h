@@ -0,0 +1 @@
+int reproducible_a(int);
@@ -0,0 +1,2 @@
+#include "a.h"
+static inline int reproducible_b(int x) { return reproducible_a(x) + 1; }
@@ -0,0 +1,38 @@
+// Test the standalone module cache maintenance tool.
+// REQUIRES: shell
+@import Module;
+
+// RUN: rm -rf %t
+// RUN: %clang_cc1 -fmodules -fimplicit-module-maps -F %S/Inputs -fmodules-cache-path=%t %s -verify
+// RUN: clang-module-cache %t | FileCheck %s --check-prefix=CHECK-STATS
+// CHECK-STATS: *** Module cache statistics for
+// CHECK-STATS: 1 configurations
+// CHECK-STATS: {{[0-9]+}} module files, {{[0-9]+}} bytes
+// CHECK-STATS-NOT: pruned
+
+// Add a stale module file next to the ones that were just built.
+// RUN: ls %t/*/modules.idx
+// RUN: echo stale > %t/Stale-0000.pcm
+// RUN: mv %t/Stale-0000.pcm %t/*/
+// RUN: touch -a -t 201101010000 %t/*/Stale-0000.pcm
+
+// RUN: clang-module-cache %t -prune-after=345600 -dry-run -v | FileCheck %s --check-prefix=CHECK-DRY
+// CHECK-DRY: prune: {{.*}}Stale-0000.pcm
+// CHECK-DRY: 1 configurations
+// CHECK-DRY: 1 stale module files pruned, 6 bytes
+// RUN: ls %t/*/Stale-0000.pcm %t/*/modules.idx
+
+// Pruning also removes the global module index, which the next compilation
+// rebuilds.
+// RUN: clang-module-cache %t -prune-after=345600 | FileCheck %s --check-prefix=CHECK-RUN
+// CHECK-RUN: 1 stale module files pruned, 6 bytes
+// RUN: ls %t/* | not grep Stale-0000.pcm
+// RUN: ls %t/* | not grep modules.idx
+// RUN: %clang_cc1 -fmodules -fimplicit-module-maps -F %S/Inputs -fmodules-cache-path=%t %s -verify
+// RUN: ls %t/*/modules.idx
+
+// A second pass finds nothing left to prune.
+// RUN: clang-module-cache %t -prune-after=345600 | FileCheck %s --check-prefix=CHECK-AGAIN
+// CHECK-AGAIN: 0 stale module files pruned
+
+// expected-no-diagnostics
@@ -0,0 +1,21 @@
+// RUN: rm -rf %t
+// RUN: %clang_cc1 -fmodules -fimplicit-module-maps -fmodules-cache-path=%t \
+// RUN:   -I %S/Inputs/namespace-reconcile -std=c++11 -verify %s
+// expected-no-diagnostics
+
+// Names that were looked up in a namespace before another module extended it
+// must still find the declarations added by that module.
+
+#include "a.h"
+
+int a1 = N::a();
+namespace N { int local(); }
+int l1 = N::local();
+
+#include "b.h"
+
+static_assert(sizeof(N::a(0)) == sizeof(long), "");
+int a2 = N::a();
+int b1 = N::b();
+int c1 = N::c();
+int l2 = N::local();
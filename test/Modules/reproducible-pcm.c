@@ -0,0 +1,55 @@
+// Check that -freproducible-pcm together with -fpcm-path-root produces the
+// same module file when the module is built in two different directories.
+//
+// RUN: rm -rf %t
+// RUN: mkdir -p %t/a %t/b
+// RUN: cp %S/Inputs/reproducible-pcm/* %t/a
+// RUN: cp %S/Inputs/reproducible-pcm/* %t/b
+//
+// RUN: cd %t/a && %clang_cc1 -fmodules -fno-implicit-modules \
+// RUN:   -freproducible-pcm -fpcm-path-root=%t/a \
+// RUN:   -fmodule-name=Reproducible -emit-module -x c module.modulemap \
+// RUN:   -o %t/a.pcm
+// RUN: cd %t/b && %clang_cc1 -fmodules -fno-implicit-modules \
+// RUN:   -freproducible-pcm -fpcm-path-root=%t/b \
+// RUN:   -fmodule-name=Reproducible -emit-module -x c module.modulemap \
+// RUN:   -o %t/b.pcm
+// RUN: cmp %t/a.pcm %t/b.pcm
+//
+// Without the flags, the module directory is embedded in the module file.
+// RUN: cd %t/a && %clang_cc1 -fmodules -fno-implicit-modules \
+// RUN:   -fmodule-name=Reproducible -emit-module -x c module.modulemap \
+// RUN:   -o %t/a-default.pcm
+// RUN: cd %t/b && %clang_cc1 -fmodules -fno-implicit-modules \
+// RUN:   -fmodule-name=Reproducible -emit-module -x c module.modulemap \
+// RUN:   -o %t/b-default.pcm
+// RUN: not cmp %t/a-default.pcm %t/b-default.pcm
+//
+// Implicitly built modules are signed with a hash of their contents, so they
+// are identical as well, and the signature changes along with the options.
+// RUN: cd %t/a && %clang_cc1 -fmodules -fimplicit-module-maps \
+// RUN:   -fmodules-cache-path=cache -fdisable-module-hash \
+// RUN:   -freproducible-pcm -fpcm-path-root=%t/a -I . -fsyntax-only -verify %s
+// RUN: cd %t/b && %clang_cc1 -fmodules -fimplicit-module-maps \
+// RUN:   -fmodules-cache-path=cache -fdisable-module-hash \
+// RUN:   -freproducible-pcm -fpcm-path-root=%t/b -I . -fsyntax-only -verify %s
+// RUN: cmp %t/a/cache/Reproducible.pcm %t/b/cache/Reproducible.pcm
+// RUN: cd %t/b && %clang_cc1 -fmodules -fimplicit-module-maps \
+// RUN:   -fmodules-cache-path=cache-d -fdisable-module-hash -DOTHER \
+// RUN:   -freproducible-pcm -fpcm-path-root=%t/b -I . -fsyntax-only -verify %s
+// RUN: not cmp %t/b/cache/Reproducible.pcm %t/b/cache-d/Reproducible.pcm
+//
+// The implicitly built module is reused rather than rebuilt.
+// RUN: cd %t/a && %clang_cc1 -fmodules -fimplicit-module-maps \
+// RUN:   -fmodules-cache-path=cache -fdisable-module-hash -Rmodule-build \
+// RUN:   -freproducible-pcm -fpcm-path-root=%t/a -I . -fsyntax-only -verify %s
+//
+// The reproducible module file can be used from its path root.
+// RUN: cd %t/a && %clang_cc1 -fmodules -fno-implicit-modules \
+// RUN:   -fmodule-map-file=module.modulemap -fmodule-file=%t/b.pcm -I . \
+// RUN:   -fsyntax-only -verify %s
+
+// expected-no-diagnostics
+#include "b.h"
+
+int f(int x) { return reproducible_b(x); }
@@ -0,0 +1,71 @@
+// RUN: %clang_cc1 -verify -triple x86_64-unknown-linux-gnu -fopenmp -x c -emit-llvm %s -o - | FileCheck %s
+// RUN: %clang_cc1 -fopenmp -x c -triple x86_64-unknown-linux-gnu -emit-pch -o %t %s
+// RUN: %clang_cc1 -fopenmp -x c -triple x86_64-unknown-linux-gnu -include-pch %t -verify %s -emit-llvm -o - | FileCheck %s
+// expected-no-diagnostics
+#ifndef HEADER
+#define HEADER
+
+#pragma omp declare simd notinbranch
+double sq(double x) { return x * x; }
+
+// CHECK-LABEL: define <2 x double> @_ZGVbN2v_sq(<2 x double>
+// CHECK-SAME: #[[SSE:[0-9]+]]
+// CHECK: simd.lane:
+// CHECK: [[LANE:%.+]] = phi i32 [ 0, %entry ], [ [[NEXT:%.+]], %simd.lane.next ]
+// CHECK: [[X:%.+]] = load double, double*
+// CHECK: [[R:%.+]] = call double @sq(double [[X]])
+// CHECK: store double [[R]], double*
+// CHECK: simd.lane.next:
+// CHECK: [[NEXT]] = add nuw i32 [[LANE]], 1
+// CHECK: icmp eq i32 [[NEXT]], 2
+// CHECK: simd.lane.end:
+// CHECK: [[RET:%.+]] = load <2 x double>, <2 x double>*
+// CHECK: ret <2 x double> [[RET]]
+
+// CHECK-LABEL: define <4 x double> @_ZGVcN4v_sq(<4 x double>
+// CHECK-SAME: #[[AVX:[0-9]+]]
+// CHECK-LABEL: define <4 x double> @_ZGVdN4v_sq(<4 x double>
+// CHECK-SAME: #[[AVX2:[0-9]+]]
+// CHECK-LABEL: define <8 x double> @_ZGVeN8v_sq(<8 x double>
+// CHECK-SAME: #[[AVX512:[0-9]+]]
+
+#pragma omp declare simd inbranch uniform(a) linear(i)
+float get(float *a, int i) { return a[i]; }
+
+// CHECK-LABEL: define <4 x float> @_ZGVbM4ul_get(float* {{%.+}}, i32 {{%.+}}, <4 x i32>
+// CHECK: icmp ne i32
+// CHECK: simd.lane.body:
+// CHECK: [[OFF:%.+]] = mul i32 {{%.+}}, 1
+// CHECK: [[I:%.+]] = add i32 {{%.+}}, [[OFF]]
+// CHECK: call float @get(float* {{%.+}}, i32 [[I]])
+
+// The mask of an AVX-512 variant has a bit for each lane.
+// CHECK-LABEL: define <16 x float> @_ZGVeM16ul_get(float* {{%.+}}, i32 {{%.+}}, i16 [[MASK:%.+]])
+// CHECK: [[LANE16:%.+]] = trunc i32 {{%.+}} to i16
+// CHECK: [[BITS:%.+]] = lshr i16 [[MASK]], [[LANE16]]
+// CHECK: [[BIT:%.+]] = and i16 [[BITS]], 1
+// CHECK: icmp ne i16 [[BIT]], 0
+
+#pragma omp declare simd notinbranch simdlen(4) linear(p : 2)
+void scale(double *p, double f) { *p *= f; }
+
+// The step of a linear pointer is mangled in bytes.
+// CHECK-LABEL: define void @_ZGVbN4l16v_scale(double* {{%.+}}, <4 x double>
+// CHECK: [[OFF:%.+]] = mul i64 {{%.+}}, 16
+// CHECK: [[BYTES:%.+]] = bitcast double* {{%.+}} to i8*
+// CHECK: [[ADDR:%.+]] = getelementptr i8, i8* [[BYTES]], i64 [[OFF]]
+// CHECK: [[P:%.+]] = bitcast i8* [[ADDR]] to double*
+// CHECK: call void @scale(double* [[P]], double
+// CHECK: ret void
+
+// Structures passed by value have no vector variants.
+struct S { int x[10]; };
+#pragma omp declare simd notinbranch
+int sum(struct S s) { return s.x[0]; }
+// CHECK-NOT: define {{.*}}@_ZGV{{.*}}_sum(
+
+// CHECK: attributes #[[SSE]] = {{.*}}"target-features"="{{[^"]*}}+sse2
+// CHECK: attributes #[[AVX]] = {{.*}}"target-features"="{{[^"]*}}+avx
+// CHECK: attributes #[[AVX2]] = {{.*}}"target-features"="{{[^"]*}}+avx2
+// CHECK: attributes #[[AVX512]] = {{.*}}"target-features"="{{[^"]*}}+avx512f
+#endif
@@ -0,0 +1,66 @@
+// RUN: %clang_cc1 -verify -fopenmp -fopenmp-inline-static-schedule -x c++ -triple x86_64-unknown-unknown -emit-llvm %s -o - | FileCheck %s
+// RUN: %clang_cc1 -verify -fopenmp -x c++ -triple x86_64-unknown-unknown -emit-llvm %s -o - | FileCheck %s --check-prefix=RUNTIME
+// RUN: %clang -### -fopenmp=libomp -fopenmp-inline-static-schedule -c %s 2>&1 | FileCheck %s --check-prefix=DRIVER
+// RUN: %clang -### -fopenmp=libomp -fopenmp-inline-static-schedule -fno-openmp-inline-static-schedule -c %s 2>&1 | FileCheck %s --check-prefix=NO-DRIVER
+//
+// expected-no-diagnostics
+
+// DRIVER: "-fopenmp-inline-static-schedule"
+// NO-DRIVER-NOT: "-fopenmp-inline-static-schedule"
+
+// RUNTIME-LABEL: define {{.*}}void @{{.*}}static_nonchunked
+// RUNTIME: call void @__kmpc_for_static_init_4(
+// RUNTIME: call void @__kmpc_for_static_fini(
+
+// CHECK-LABEL: define {{.*}}void @{{.*}}static_nonchunked{{.*}}(float* {{.+}}, i32 {{.+}})
+void static_nonchunked(float *a, int n) {
+  // CHECK-NOT: __kmpc_for_static_init
+  // CHECK: [[TID:%.+]] = call i32 @omp_get_thread_num()
+  // CHECK: [[NTH:%.+]] = call i32 @omp_get_num_threads()
+  // CHECK: [[LB:%.+]] = load i32, i32* [[OMP_LB:%[^,]+]]
+  // CHECK: [[UB:%.+]] = load i32, i32* [[OMP_UB:%[^,]+]]
+  // CHECK: [[DIFF:%.+]] = sub i32 [[UB]], [[LB]]
+  // CHECK: [[TRIP:%.+]] = add i32 [[DIFF]], 1
+  // CHECK: [[REM:%.+]] = urem i32 [[TRIP]], [[NTH]]
+  // CHECK: [[HASREM:%.+]] = icmp ne i32 [[REM]], 0
+  // CHECK: [[DIV:%.+]] = udiv i32 [[TRIP]], [[NTH]]
+  // CHECK: [[EXTRA:%.+]] = zext i1 [[HASREM]] to i32
+  // CHECK: [[CHUNK:%.+]] = add i32 [[DIV]], [[EXTRA]]
+  // CHECK: [[OFFSET:%.+]] = mul i32 [[TID]], [[CHUNK]]
+  // CHECK: [[NEWLB:%.+]] = add i32 [[LB]], [[OFFSET]]
+  // CHECK: store i32 [[NEWLB]], i32* [[OMP_LB]]
+  // CHECK: store i32 {{%.+}}, i32* [[OMP_UB]]
+#pragma omp for schedule(static)
+  for (int i = 0; i < n; ++i)
+    a[i] = i;
+  // CHECK-NOT: __kmpc_for_static_fini
+  // CHECK: call void @__kmpc_barrier(
+  // CHECK: ret void
+}
+
+// Chunked static schedules still go through the runtime.
+// CHECK-LABEL: define {{.*}}void @{{.*}}static_chunked
+void static_chunked(float *a, int n) {
+  // CHECK: call void @__kmpc_for_static_init_4(
+  // CHECK: call void @__kmpc_for_static_fini(
+#pragma omp for schedule(static, 4)
+  for (int i = 0; i < n; ++i)
+    a[i] = i;
+  // CHECK: ret void
+}
+
+// CHECK-LABEL: define {{.*}}void @{{.*}}sections
+void sections(float *a) {
+  // CHECK-NOT: __kmpc_for_static_init
+  // CHECK: call i32 @omp_get_thread_num()
+  // CHECK: call i32 @omp_get_num_threads()
+#pragma omp sections
+  {
+#pragma omp section
+    a[0] = 0;
+#pragma omp section
+    a[1] = 1;
+  }
+  // CHECK-NOT: __kmpc_for_static_fini
+  // CHECK: ret void
+}
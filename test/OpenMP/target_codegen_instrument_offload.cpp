@@ -0,0 +1,53 @@
+// RUN: %clang_cc1 -verify -fopenmp -x c++ -triple x86_64-unknown-linux-gnu -fopenmp-targets=x86_64-unknown-linux-gnu -fopenmp-instrument-offload -emit-llvm %s -o - | FileCheck %s
+// RUN: %clang_cc1 -verify -fopenmp -x c++ -triple x86_64-unknown-linux-gnu -fopenmp-targets=x86_64-unknown-linux-gnu -emit-llvm %s -o - | FileCheck %s --check-prefix NOINSTR
+// expected-no-diagnostics
+
+// NOINSTR-NOT: __omp_offload_instrument
+
+// CHECK-DAG: [[LOCT:@.+]] = private unnamed_addr constant [{{[0-9]+}} x i8] c"{{.*}}target_codegen_instrument_offload.cpp:[[@LINE+33]]:{{[0-9]+}}\00"
+// CHECK-DAG: [[LOCB:@.+]] = private unnamed_addr constant [{{[0-9]+}} x i8] c"{{.*}}target_codegen_instrument_offload.cpp:[[@LINE+37]]:{{[0-9]+}}\00"
+// CHECK-DAG: [[LOCU:@.+]] = private unnamed_addr constant [{{[0-9]+}} x i8] c"{{.*}}target_codegen_instrument_offload.cpp:[[@LINE+41]]:{{[0-9]+}}\00"
+
+// CHECK-LABEL: define {{.*}}@_Z3fooi(
+// CHECK:       call void @__omp_offload_instrument_enter(i32 0, i8* getelementptr {{.*}}[[LOCT]]
+// CHECK-NEXT:  [[RET:%.+]] = call i32 @__tgt_target(
+// CHECK-NEXT:  call void @__omp_offload_instrument_exit(i32 0, i8* getelementptr {{.*}}[[LOCT]]
+// CHECK-NEXT:  store i32 [[RET]], i32* [[ERR:%.+]],
+// CHECK:       [[FAIL:%.+]] = icmp ne i32
+// CHECK-NEXT:  br i1 [[FAIL]], label %[[FALLBACK:.+]], label %[[CONT:[^,]+]]
+// CHECK:       [[FALLBACK]]
+// CHECK-NEXT:  call void @__omp_offload_instrument_enter(i32 4, i8* getelementptr {{.*}}[[LOCT]]
+// CHECK-NEXT:  call void @{{.+}}(
+// CHECK-NEXT:  call void @__omp_offload_instrument_exit(i32 4, i8* getelementptr {{.*}}[[LOCT]]
+
+// CHECK:       call void @__omp_offload_instrument_enter(i32 1, i8* getelementptr {{.*}}[[LOCB]]
+// CHECK-NEXT:  call void @__tgt_target_data_begin(
+// CHECK-NEXT:  call void @__omp_offload_instrument_exit(i32 1, i8* getelementptr {{.*}}[[LOCB]]
+// CHECK:       call void @__omp_offload_instrument_enter(i32 2, i8* getelementptr {{.*}}[[LOCB]]
+// CHECK-NEXT:  call void @__tgt_target_data_end(
+// CHECK-NEXT:  call void @__omp_offload_instrument_exit(i32 2, i8* getelementptr {{.*}}[[LOCB]]
+
+// CHECK:       call void @__omp_offload_instrument_enter(i32 3, i8* getelementptr {{.*}}[[LOCU]]
+// CHECK-NEXT:  call void @__tgt_target_data_update(
+// CHECK-NEXT:  call void @__omp_offload_instrument_exit(i32 3, i8* getelementptr {{.*}}[[LOCU]]
+
+// CHECK-DAG: declare void @__omp_offload_instrument_enter(i32, i8*)
+// CHECK-DAG: declare void @__omp_offload_instrument_exit(i32, i8*)
+
+int foo(int n) {
+  int a[10];
+
+  #pragma omp target map(tofrom: a)
+  {
+    a[0] += n;
+  }
+
+  #pragma omp target data map(to: a)
+  {
+    ++a[1];
+  }
+
+  #pragma omp target update to(a)
+
+  return a[0];
+}
@@ -0,0 +1,36 @@
+// Test that -fpch-instantiate-templates performs the instantiations that a
+// PCH requires when building it, and leaves the ones whose templates are not
+// defined yet to the users of the PCH.
+
+// RUN: %clang_cc1 -std=c++11 -triple x86_64-unknown-linux-gnu -Wundefined-func-template -fpch-instantiate-templates -emit-pch -verify -o %t %s
+// RUN: %clang_cc1 -std=c++11 -triple x86_64-unknown-linux-gnu -x ast -ast-dump -ast-dump-filter twice %t | FileCheck -check-prefix=INST %s
+// RUN: %clang_cc1 -std=c++11 -triple x86_64-unknown-linux-gnu -include-pch %t -emit-llvm -o - %s | FileCheck %s
+
+// RUN: %clang_cc1 -std=c++11 -triple x86_64-unknown-linux-gnu -emit-pch -o %t.noinst %s
+// RUN: %clang_cc1 -std=c++11 -triple x86_64-unknown-linux-gnu -x ast -ast-dump -ast-dump-filter twice %t.noinst | FileCheck -check-prefix=NOINST %s
+// RUN: %clang_cc1 -std=c++11 -triple x86_64-unknown-linux-gnu -include-pch %t.noinst -emit-llvm -o - %s | FileCheck %s
+
+#ifndef HEADER
+#define HEADER
+
+// expected-no-diagnostics
+
+template <typename T> T twice(T x) { return x + x; }
+template <typename T> T later(T x);
+
+inline int useTwice() { return twice(21); }
+inline int useLater() { return later(2); }
+
+// INST: BinaryOperator {{.*}} 'int' '+'
+// NOINST-NOT: BinaryOperator {{.*}} 'int' '+'
+
+#else
+
+template <typename T> T later(T x) { return x * 3; }
+
+int f() { return useTwice() + useLater(); }
+
+// CHECK-DAG: define linkonce_odr i32 @_Z5twiceIiET_S0_(i32
+// CHECK-DAG: define linkonce_odr i32 @_Z5laterIiET_S0_(i32
+
+#endif
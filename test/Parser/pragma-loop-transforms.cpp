@@ -0,0 +1,81 @@
+// RUN: %clang_cc1 -std=c++11 -verify %s
+
+// Note that this puts the expected lines before the directives to work around
+// limitations in the -verify mode.
+
+template <int V>
+void test_nontype_template_unroll_and_jam(int *List, int Length) {
+  /* expected-error {{invalid value '-1'; must be positive}} */ #pragma clang loop unroll_and_jam_count(V)
+  for (int i = 0; i < Length; i++) {
+    List[i] = i;
+  }
+}
+
+void test(int *List, int Length) {
+  int i = 0;
+
+#pragma clang loop unroll_and_jam(enable)
+#pragma clang loop vectorize_predicate(enable)
+#pragma clang loop pipeline(disable)
+  while (i + 1 < Length) {
+    List[i] = i;
+  }
+
+#pragma clang loop unroll_and_jam_count(4) vectorize_predicate(disable)
+#pragma clang loop pipeline_initiation_interval(10)
+  while (i + 2 < Length) {
+    List[i] = i;
+  }
+
+  test_nontype_template_unroll_and_jam<4>(List, Length);
+  /* expected-note {{in instantiation of function template specialization}} */ test_nontype_template_unroll_and_jam<-1>(List, Length);
+
+/* expected-error {{expected '('}} */ #pragma clang loop unroll_and_jam
+/* expected-error {{expected '('}} */ #pragma clang loop pipeline
+/* expected-error {{expected ')'}} */ #pragma clang loop vectorize_predicate(enable
+/* expected-error {{expected ')'}} */ #pragma clang loop pipeline_initiation_interval(4
+
+/* expected-error {{missing argument; expected 'enable' or 'disable'}} */ #pragma clang loop unroll_and_jam()
+/* expected-error {{missing argument; expected 'enable' or 'disable'}} */ #pragma clang loop vectorize_predicate()
+/* expected-error {{missing argument; expected an integer value}} */ #pragma clang loop unroll_and_jam_count()
+/* expected-error {{missing argument; expected an integer value}} */ #pragma clang loop pipeline_initiation_interval()
+/* expected-error {{invalid argument; expected 'disable'}} */ #pragma clang loop pipeline()
+
+/* expected-error {{invalid argument; expected 'enable' or 'disable'}} */ #pragma clang loop unroll_and_jam(full)
+/* expected-error {{invalid argument; expected 'enable' or 'disable'}} */ #pragma clang loop vectorize_predicate(assume_safety)
+/* expected-error {{invalid argument; expected 'disable'}} */ #pragma clang loop pipeline(enable)
+/* expected-error {{invalid argument; expected 'disable'}} */ #pragma clang loop pipeline(badidentifier)
+  while (i - 3 < Length) {
+    List[i] = i;
+  }
+
+/* expected-error {{invalid value '0'; must be positive}} */ #pragma clang loop unroll_and_jam_count(0)
+/* expected-error {{invalid value '0'; must be positive}} */ #pragma clang loop pipeline_initiation_interval(0)
+  while (i - 4 < Length) {
+    List[i] = i;
+  }
+
+// The attributes are processed in reverse order; see pragma-loop.cpp.
+
+/* expected-error {{incompatible directives 'unroll_and_jam(disable)' and 'unroll_and_jam_count(4)'}} */ #pragma clang loop unroll_and_jam_count(4)
+#pragma clang loop unroll_and_jam(disable)
+/* expected-error {{incompatible directives 'pipeline(disable)' and 'pipeline_initiation_interval(10)'}} */ #pragma clang loop pipeline_initiation_interval(10)
+#pragma clang loop pipeline(disable)
+  while (i - 5 < Length) {
+    List[i] = i;
+  }
+
+/* expected-error {{duplicate directives 'unroll_and_jam(disable)' and 'unroll_and_jam(enable)'}} */ #pragma clang loop unroll_and_jam(enable)
+#pragma clang loop unroll_and_jam(disable)
+/* expected-error {{duplicate directives 'vectorize_predicate(disable)' and 'vectorize_predicate(enable)'}} */ #pragma clang loop vectorize_predicate(enable)
+#pragma clang loop vectorize_predicate(disable)
+/* expected-error {{duplicate directives 'unroll_and_jam_count(8)' and 'unroll_and_jam_count(4)'}} */ #pragma clang loop unroll_and_jam_count(4)
+#pragma clang loop unroll_and_jam_count(8)
+  while (i - 6 < Length) {
+    List[i] = i;
+  }
+
+#pragma clang loop unroll_and_jam(enable)
+/* expected-error {{expected a for, while, or do-while loop to follow '#pragma clang loop'}} */ int j = Length;
+  List[0] = List[1];
+}
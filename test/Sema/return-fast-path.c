@@ -0,0 +1,31 @@
+// RUN: %clang_cc1 -fsyntax-only -verify -print-stats %s 2>&1 | FileCheck %s
+
+// Functions whose bodies end in a return statement cannot fall off the end,
+// so no CFG is built to check them. Only f3 and f4 are analyzed.
+// CHECK: 2 functions analyzed (0 w/o CFGs).
+
+int f1(int x) {
+  if (x)
+    return 1;
+  return 0;
+}
+
+int f2(int x) {
+  while (x)
+    if (--x == 3)
+      return x;
+  return -1;
+}
+
+int f3(int x) {
+  if (x)
+    return 1;
+} // expected-warning {{control may reach end of non-void function}}
+
+int f4(int x) {
+  if (x)
+    goto done;
+  return 0;
+done:
+  x++;
+} // expected-warning {{control may reach end of non-void function}}
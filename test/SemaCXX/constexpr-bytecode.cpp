@@ -0,0 +1,111 @@
+// RUN: %clang_cc1 -std=c++14 -fsyntax-only -verify %s
+// RUN: %clang_cc1 -std=c++14 -fsyntax-only -verify %s -fexperimental-constexpr-bytecode -print-stats 2>&1 | FileCheck %s
+
+// Functions that only compute with integers are evaluated by the bytecode
+// interpreter; everything else, and every evaluation that is not a constant
+// expression, falls back to the tree walker and must be diagnosed the same
+// way with and without -fexperimental-constexpr-bytecode.
+
+// Check that calls were evaluated by the interpreter and not only by the
+// tree walker.
+// CHECK: *** Constexpr Bytecode Stats:
+// CHECK-NEXT: {{[1-9][0-9]*}}/{{[0-9]+}} constexpr functions compiled to bytecode
+// CHECK-NEXT: {{[1-9][0-9]*}}/{{[0-9]+}} calls evaluated by the bytecode interpreter
+
+typedef unsigned long long u64;
+
+constexpr u64 fnv1a(u64 Seed, int N) {
+  u64 Hash = 14695981039346656037ULL;
+  for (int I = 0; I < N; ++I) {
+    Hash ^= (Seed >> (8 * (I % 8))) & 0xff;
+    Hash *= 1099511628211ULL;
+  }
+  return Hash;
+}
+static_assert(fnv1a(0, 0) == 14695981039346656037ULL, "");
+static_assert(fnv1a(0x0123456789abcdefULL, 4096) != fnv1a(0, 4096), "");
+
+constexpr int fib(int N) { return N < 2 ? N : fib(N - 1) + fib(N - 2); }
+static_assert(fib(20) == 6765, "");
+
+constexpr bool isPrime(unsigned N) {
+  if (N < 2)
+    return false;
+  for (unsigned D = 2; D * D <= N; ++D)
+    if (N % D == 0)
+      return false;
+  return true;
+}
+constexpr int countPrimes(int Limit) {
+  int Count = 0;
+  int N = 0;
+  while (true) {
+    if (N > Limit)
+      break;
+    if (isPrime(N++))
+      ++Count;
+  }
+  return Count;
+}
+static_assert(countPrimes(10000) == 1229, "");
+
+enum class Color : unsigned char { Red, Green, Blue };
+constexpr int weight(Color C) {
+  switch (C) {
+  case Color::Red:
+    return 3;
+  case Color::Green: {
+    int W = 1;
+    W <<= 2;
+    return W;
+  }
+  default:
+    break;
+  }
+  return 7;
+}
+static_assert(weight(Color::Red) == 3 && weight(Color::Green) == 4 &&
+              weight(Color::Blue) == 7, "");
+
+constexpr int digits(long long N) {
+  int D = 0;
+  do {
+    N /= 10;
+    ++D;
+  } while (N != 0);
+  return D;
+}
+static_assert(digits(0) == 1 && digits(-1234567890123LL) == 13, "");
+
+constexpr unsigned char wrap(unsigned char C) { return C + 1; }
+static_assert(wrap(255) == 0, "");
+
+constexpr signed char inc(signed char C) { return ++C; }
+static_assert(inc(5) == 6, "");
+
+template <int N> constexpr int scaled(int X) { return X * N + sizeof(X); }
+static_assert(scaled<3>(2) == 10, "");
+
+constexpr int twice(int X, int Y = 2) { return X * Y; }
+static_assert(twice(21) == 42, "");
+
+constexpr int overflow(int X) {
+  return X + 1; // expected-note {{value 2147483648 is outside the range}}
+}
+static_assert(overflow(2147483647), ""); // expected-error {{constant expression}} expected-note {{in call to 'overflow(2147483647)'}}
+
+constexpr int divide(int X, int Y) {
+  return X / Y; // expected-note {{division by zero}}
+}
+static_assert(divide(1, 0), ""); // expected-error {{constant expression}} expected-note {{in call to 'divide(1, 0)'}}
+
+constexpr int shift(int X, int N) {
+  return X << N; // expected-note {{shift count 40 >= width of type 'int'}}
+}
+static_assert(shift(1, 40), ""); // expected-error {{constant expression}} expected-note {{in call to 'shift(1, 40)'}}
+
+constexpr int noReturn(int X) {
+  if (X)
+    return X;
+} // expected-warning {{control may reach end of non-void function}} expected-note {{control reached end of constexpr function}}
+static_assert(noReturn(0), ""); // expected-error {{constant expression}} expected-note {{in call to 'noReturn(0)'}}
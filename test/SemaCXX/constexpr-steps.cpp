@@ -1,5 +1,6 @@
 // RUN: %clang_cc1 -std=c++1y -fsyntax-only -verify %s -DMAX=1234 -fconstexpr-steps 1234
 // RUN: %clang_cc1 -std=c++1y -fsyntax-only -verify %s -DMAX=10 -fconstexpr-steps 10
+// RUN: %clang_cc1 -std=c++1y -fsyntax-only -verify %s -DMAX=1234 -fconstexpr-steps 1234 -fexperimental-constexpr-bytecode
 // RUN: %clang -std=c++1y -fsyntax-only -Xclang -verify %s -DMAX=12345 -fconstexpr-steps=12345
 
 // This takes a total of n + 4 steps according to our current rules:
@@ -15,3 +16,29 @@ constexpr bool steps(int n) {
 
 static_assert(steps((MAX - 4)), ""); // ok
 static_assert(steps((MAX - 3)), ""); // expected-error {{constant}} expected-note{{call}}
+
+// The switch steps through its body until it reaches the selected label:
+//  - n + 3 steps for the function body, the 'for' loop and its body as above
+//  - One for the 'switch' statement
+//  - For 'case 0', two for the body and the label followed by one for 'break'
+//  - For 'case 1', four for the body, 'case 0', its 'break' and the label
+//    followed by one for 'break'
+//  - None for the body if no label matches
+//  - One for the 'return' statement
+constexpr bool switchSteps(int n, int c) {
+  for (int k = 0; k != n; ++k) {}
+  switch (c) {
+  case 0:
+    break;
+  case 1:
+    break;
+  }
+  return true; // expected-note 3 {{step limit}}
+}
+
+static_assert(switchSteps((MAX - 8), 0), ""); // ok
+static_assert(switchSteps((MAX - 7), 0), ""); // expected-error {{constant}} expected-note{{call}}
+static_assert(switchSteps((MAX - 10), 1), ""); // ok
+static_assert(switchSteps((MAX - 9), 1), ""); // expected-error {{constant}} expected-note{{call}}
+static_assert(switchSteps((MAX - 5), 2), ""); // ok
+static_assert(switchSteps((MAX - 4), 2), ""); // expected-error {{constant}} expected-note{{call}}
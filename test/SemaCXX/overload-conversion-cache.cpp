@@ -0,0 +1,65 @@
+// RUN: %clang_cc1 -fsyntax-only -verify -std=c++11 %s
+// RUN: %clang_cc1 -fsyntax-only -std=c++11 -print-stats -DNO_ERRORS %s 2>&1 \
+// RUN:   | FileCheck %s
+
+// Standard conversions that only depend on the types involved are cached.
+// Make sure that the conversions that also depend on the argument expression
+// are still computed for each argument.
+
+// CHECK: cacheable standard conversion checks, {{[1-9][0-9]*}} cache hits.
+
+template<typename T, typename U> struct is_same {
+  static const bool value = false;
+};
+template<typename T> struct is_same<T, T> { static const bool value = true; };
+#define CHECK_TYPE(E, T) static_assert(is_same<decltype(E), T>::value, #E)
+
+int f(int);
+double f(double);
+char *f(char *);
+const void *f(const void *);
+
+void test_arith(short sh, float fl, char *cp, const char *ccp, bool b) {
+  CHECK_TYPE(f(sh), int);
+  CHECK_TYPE(f(sh), int);
+  CHECK_TYPE(f(fl), double);
+  CHECK_TYPE(f(fl), double);
+  CHECK_TYPE(f(cp), char *);
+  CHECK_TYPE(f(ccp), const void *);
+  CHECK_TYPE(f(ccp), const void *);
+  CHECK_TYPE(f(b), int);
+  CHECK_TYPE(f(sh + sh), int);
+}
+
+struct S {
+  unsigned u : 31;
+  unsigned full;
+};
+
+int p(int);
+long p(long);
+
+#ifndef NO_ERRORS
+char *n(char *); // expected-note {{candidate}}
+double n(double); // expected-note {{candidate}}
+
+int q(int); // expected-note 2{{candidate}}
+long q(long); // expected-note 2{{candidate}}
+
+void test_null(int i) {
+  CHECK_TYPE(n(i), double);
+  n(0); // expected-error {{call to 'n' is ambiguous}}
+  CHECK_TYPE(n(i), double);
+}
+
+void test_bitfield(S s) {
+  q(s.full); // expected-error {{call to 'q' is ambiguous}}
+  CHECK_TYPE(q(s.u), int);
+  q(s.full); // expected-error {{call to 'q' is ambiguous}}
+}
+#endif
+
+void test_bitfield_promotion(S s) {
+  CHECK_TYPE(p(s.u), int);
+  CHECK_TYPE(p(s.u), int);
+}
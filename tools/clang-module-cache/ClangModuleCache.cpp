@@ -0,0 +1,226 @@
+//===-- clang-module-cache/ClangModuleCache.cpp ---------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief This file implements clang-module-cache, a standalone maintenance
+/// tool for implicit module caches. It scans every configuration-specific
+/// sub-cache created by CompilerInstance::getSpecificModuleCachePath,
+/// reports size and occupancy statistics and removes module files that have
+/// not been used recently.
+///
+//===----------------------------------------------------------------------===//
+
+#include "clang/Basic/Version.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/Signals.h"
+#include "llvm/Support/raw_ostream.h"
+#include <cerrno>
+#include <ctime>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+using namespace llvm;
+
+static cl::OptionCategory
+    ClangModuleCacheCategory("clang-module-cache options");
+
+static cl::opt<std::string>
+    CachePath(cl::Positional, cl::Required, cl::desc("<module cache path>"),
+              cl::cat(ClangModuleCacheCategory));
+
+static cl::opt<unsigned>
+    PruneAfter("prune-after",
+               cl::desc("Remove module files that have not been accessed in "
+                        "this many seconds (0 disables pruning)"),
+               cl::init(0), cl::cat(ClangModuleCacheCategory));
+
+static cl::opt<bool>
+    DryRun("dry-run",
+           cl::desc("Report what would be removed, but leave the module "
+                    "cache untouched"),
+           cl::init(false), cl::cat(ClangModuleCacheCategory));
+
+static cl::opt<bool>
+    Verbose("v", cl::desc("Print every file that is removed"),
+            cl::init(false), cl::cat(ClangModuleCacheCategory));
+
+namespace {
+
+/// \brief A module file found in one of the configuration directories.
+struct ModuleFileInfo {
+  std::string Path;
+  uint64_t Size;
+  time_t AccessTime;
+};
+
+/// \brief Occupancy of a single configuration-specific sub-cache.
+struct ConfigurationInfo {
+  std::string Path;
+  std::vector<ModuleFileInfo> ModuleFiles;
+  uint64_t TotalSize = 0;
+};
+
+/// \brief Totals accumulated across the whole module cache.
+struct CacheStatistics {
+  unsigned NumConfigurations = 0;
+  unsigned NumModuleFiles = 0;
+  uint64_t TotalSize = 0;
+  unsigned NumPruned = 0;
+  uint64_t PrunedSize = 0;
+  unsigned NumErrors = 0;
+};
+
+} // end anonymous namespace
+
+/// \brief Collect the module files of every configuration directory below
+/// \p Root.
+static std::vector<ConfigurationInfo> scanModuleCache(StringRef Root,
+                                                      CacheStatistics &Stats) {
+  std::vector<ConfigurationInfo> Configurations;
+  std::error_code EC;
+  for (sys::fs::directory_iterator Dir(Root, EC), DirEnd;
+       Dir != DirEnd && !EC; Dir.increment(EC)) {
+    if (!sys::fs::is_directory(Dir->path()))
+      continue;
+
+    ConfigurationInfo Config;
+    Config.Path = Dir->path();
+    for (sys::fs::directory_iterator File(Dir->path(), EC), FileEnd;
+         File != FileEnd && !EC; File.increment(EC)) {
+      if (sys::path::extension(File->path()) != ".pcm")
+        continue;
+
+      struct stat StatBuf;
+      if (::stat(File->path().c_str(), &StatBuf))
+        continue;
+
+      ModuleFileInfo Info;
+      Info.Path = File->path();
+      Info.Size = StatBuf.st_size;
+      Info.AccessTime = StatBuf.st_atime;
+      Config.TotalSize += Info.Size;
+      Config.ModuleFiles.push_back(std::move(Info));
+    }
+
+    ++Stats.NumConfigurations;
+    Stats.NumModuleFiles += Config.ModuleFiles.size();
+    Stats.TotalSize += Config.TotalSize;
+    Configurations.push_back(std::move(Config));
+  }
+  return Configurations;
+}
+
+/// \brief Remove module files (and their validation timestamps) that have not
+/// been accessed within the last \p Seconds seconds.
+///
+/// The global module index of a configuration directory from which files
+/// were removed is removed as well; the compiler rebuilds it on its next
+/// use of the directory.
+static void pruneModuleFiles(std::vector<ConfigurationInfo> &Configurations,
+                             unsigned Seconds, CacheStatistics &Stats) {
+  time_t CurrentTime = time(nullptr);
+  for (ConfigurationInfo &Config : Configurations) {
+    std::vector<ModuleFileInfo> Kept;
+    bool RemovedAny = false;
+    for (ModuleFileInfo &Info : Config.ModuleFiles) {
+      if (CurrentTime - Info.AccessTime <= time_t(Seconds)) {
+        Kept.push_back(std::move(Info));
+        continue;
+      }
+
+      if (Verbose)
+        outs() << "prune: " << Info.Path << '\n';
+      ++Stats.NumPruned;
+      Stats.PrunedSize += Info.Size;
+      Config.TotalSize -= Info.Size;
+      if (DryRun)
+        continue;
+
+      if (sys::fs::remove(Info.Path)) {
+        errs() << "error: unable to remove '" << Info.Path << "'\n";
+        ++Stats.NumErrors;
+        continue;
+      }
+      sys::fs::remove(Info.Path + ".timestamp");
+      RemovedAny = true;
+    }
+    Config.ModuleFiles = std::move(Kept);
+    if (!RemovedAny)
+      continue;
+
+    // The global module index still refers to the removed module files.
+    SmallString<128> IndexPath(Config.Path);
+    sys::path::append(IndexPath, "modules.idx");
+    sys::fs::remove(IndexPath);
+
+    // If we removed all of the files in the directory, remove the directory
+    // itself, as the in-compiler pruning does.
+    if (Config.ModuleFiles.empty())
+      sys::fs::remove(Config.Path);
+  }
+}
+
+static void printStatistics(raw_ostream &OS,
+                            const std::vector<ConfigurationInfo> &Configurations,
+                            const CacheStatistics &Stats) {
+  OS << "*** Module cache statistics for '" << CachePath << "':\n";
+  OS << "  " << Stats.NumConfigurations << " configurations\n";
+  OS << "  " << Stats.NumModuleFiles << " module files, " << Stats.TotalSize
+     << " bytes\n";
+  for (const ConfigurationInfo &Config : Configurations) {
+    double Share = Stats.TotalSize
+                       ? 100.0 * Config.TotalSize / Stats.TotalSize
+                       : 0.0;
+    OS << "    " << sys::path::filename(Config.Path) << ": "
+       << Config.ModuleFiles.size() << " module files, " << Config.TotalSize
+       << " bytes (" << format("%.1f", Share) << "%)\n";
+  }
+  if (PruneAfter)
+    OS << "  " << Stats.NumPruned << " stale module files pruned, "
+       << Stats.PrunedSize << " bytes\n";
+}
+
+static void PrintVersion() {
+  raw_ostream &OS = outs();
+  OS << clang::getClangToolFullVersion("clang-module-cache") << '\n';
+}
+
+int main(int argc, const char **argv) {
+  sys::PrintStackTraceOnErrorSignal(argv[0]);
+
+  cl::HideUnrelatedOptions(ClangModuleCacheCategory);
+  cl::SetVersionPrinter(PrintVersion);
+  cl::ParseCommandLineOptions(
+      argc, argv,
+      "A tool to inspect and maintain an implicit module cache. It reports \n"
+      "the size of every configuration-specific sub-cache and prunes \n"
+      "module files that have not been used recently (-prune-after).\n");
+
+  SmallString<128> Root;
+  sys::path::native(CachePath, Root);
+  if (!sys::fs::is_directory(Root)) {
+    errs() << "error: '" << CachePath << "' is not a directory\n";
+    return 1;
+  }
+
+  CacheStatistics Stats;
+  std::vector<ConfigurationInfo> Configurations = scanModuleCache(Root, Stats);
+
+  if (PruneAfter)
+    pruneModuleFiles(Configurations, PruneAfter, Stats);
+
+  printStatistics(outs(), Configurations, Stats);
+  return Stats.NumErrors ? 1 : 0;
+}
@@ -14,6 +14,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Option/Arg.h"
+#include "clang/Basic/TimeTrace.h"
 #include "clang/CodeGen/ObjectFilePCHContainerOperations.h"
 #include "clang/Config/config.h"
 #include "clang/Driver/DriverDiagnostic.h"
@@ -32,6 +33,7 @@
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Support/Timer.h"
@@ -167,6 +169,30 @@ static void ensureSufficientStack() {
 static void ensureSufficientStack() {}
 #endif
 
+/// \brief Write the time trace of this compilation next to its output file,
+/// or into the current directory if there is no output file.
+static void writeTimeTrace(CompilerInstance &Clang) {
+  const FrontendOptions &Opts = Clang.getFrontendOpts();
+  SmallString<128> Path;
+  if (!Opts.OutputFile.empty() && Opts.OutputFile != "-")
+    Path = Opts.OutputFile;
+  else if (!Opts.Inputs.empty() && Opts.Inputs[0].isFile() &&
+           Opts.Inputs[0].getFile() != "-")
+    Path = llvm::sys::path::filename(Opts.Inputs[0].getFile());
+  else
+    Path = "clang";
+  llvm::sys::path::replace_extension(Path, "json");
+
+  std::error_code EC;
+  llvm::raw_fd_ostream OS(Path, EC, llvm::sys::fs::F_Text);
+  if (EC) {
+    Clang.getDiagnostics().Report(diag::err_fe_unable_to_open_output)
+        << Path << EC.message();
+    return;
+  }
+  timeTraceProfilerWrite(OS);
+}
+
 int cc1_main(ArrayRef<const char *> Argv, const char *Argv0, void *MainAddr) {
   ensureSufficientStack();
 
@@ -217,8 +243,20 @@ int cc1_main(ArrayRef<const char *> Argv, const char *Argv0, void *MainAddr) {
   if (!Success)
     return 1;
 
+  bool TimeTrace = Clang->getFrontendOpts().TimeTrace;
+  if (TimeTrace)
+    timeTraceProfilerInitialize(Clang->getFrontendOpts().TimeTraceGranularity);
+
   // Execute the frontend actions.
-  Success = ExecuteCompilerInvocation(Clang.get());
+  {
+    TimeTraceScope TimeScope("ExecuteCompiler");
+    Success = ExecuteCompilerInvocation(Clang.get());
+  }
+
+  if (TimeTrace) {
+    writeTimeTrace(*Clang);
+    timeTraceProfilerCleanup();
+  }
 
   // If any timers were active but haven't been destroyed yet, print their
   // results now.  This happens in -disable-free mode.
@@ -0,0 +1,74 @@
+//===- unittests/Serialization/ModuleManagerTest.cpp - ModuleManager tests ===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Serialization/ModuleManager.h"
+#include "clang/Basic/FileManager.h"
+#include "clang/Basic/FileSystemOptions.h"
+#include "clang/Basic/VirtualFileSystem.h"
+#include "clang/Frontend/PCHContainerOperations.h"
+#include "clang/Serialization/Module.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace clang;
+using namespace clang::serialization;
+
+namespace {
+
+class ModuleManagerTest : public ::testing::Test {
+protected:
+  ModuleManagerTest() : InMemoryFS(new vfs::InMemoryFileSystem) {
+    InMemoryFS->addFile("/a.pch", 0, MemoryBuffer::getMemBuffer("contents"));
+    InMemoryFS->addFile("/b.pch", 0, MemoryBuffer::getMemBuffer("contents"));
+  }
+
+  /// \brief Create a file manager that sees the files in \c InMemoryFS
+  /// through an overlay, as tools built on ClangTool do.
+  std::unique_ptr<FileManager> createFileManager() {
+    IntrusiveRefCntPtr<vfs::OverlayFileSystem> OverlayFS(
+        new vfs::OverlayFileSystem(vfs::getRealFileSystem()));
+    OverlayFS->pushOverlay(InMemoryFS);
+    return llvm::make_unique<FileManager>(FileSystemOptions(), OverlayFS);
+  }
+
+  ModuleFile *load(ModuleManager &Manager, StringRef FileName) {
+    ModuleFile *Module = nullptr;
+    std::string ErrorStr;
+    ModuleManager::AddModuleResult Result = Manager.addModule(
+        FileName, MK_PCH, SourceLocation(), /*ImportedBy=*/nullptr,
+        /*Generation=*/0, /*ExpectedSize=*/0, /*ExpectedModTime=*/0,
+        /*ExpectedSignature=*/0, /*ReadSignature=*/nullptr, Module, ErrorStr);
+    EXPECT_EQ(ModuleManager::NewlyLoaded, Result) << ErrorStr;
+    return Module;
+  }
+
+  IntrusiveRefCntPtr<vfs::InMemoryFileSystem> InMemoryFS;
+  RawPCHContainerReader Reader;
+};
+
+TEST_F(ModuleManagerTest, SharesBuffersBetweenManagers) {
+  std::unique_ptr<FileManager> FileMgr1 = createFileManager();
+  std::unique_ptr<FileManager> FileMgr2 = createFileManager();
+  ModuleManager Manager1(*FileMgr1, Reader);
+  ModuleManager Manager2(*FileMgr2, Reader);
+
+  ModuleFile *A1 = load(Manager1, "/a.pch");
+  ModuleFile *A2 = load(Manager2, "/a.pch");
+  ASSERT_TRUE(A1 && A2);
+  EXPECT_EQ("contents", A1->Buffer->getBuffer());
+  EXPECT_EQ(A1->Buffer.get(), A2->Buffer.get());
+
+  // A different file with the same contents gets a buffer of its own.
+  ModuleFile *B2 = load(Manager2, "/b.pch");
+  ASSERT_TRUE(B2);
+  EXPECT_NE(A2->Buffer.get(), B2->Buffer.get());
+}
+
+} // end anonymous namespace
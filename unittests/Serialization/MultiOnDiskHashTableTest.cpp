@@ -0,0 +1,248 @@
+//===- unittests/Serialization/MultiOnDiskHashTableTest.cpp ---------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "../../lib/Serialization/MultiOnDiskHashTable.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/EndianStream.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+
+using namespace llvm;
+using namespace clang::serialization;
+
+namespace {
+
+/// \brief A module file that a table can be loaded from. The member gives it
+/// the alignment that TinyPtrVector needs.
+struct TestFile {
+  int Unused;
+};
+TestFile Files[8];
+
+/// \brief Maps integer keys to lists of integers.
+struct TestReaderInfo {
+  static const int MaxTables = 4;
+
+  typedef SmallVector<uint32_t, 4> data_type;
+  struct data_type_builder {
+    data_type &Data;
+
+    data_type_builder(data_type &D) : Data(D) {}
+    void insert(uint32_t Value) {
+      if (std::find(Data.begin(), Data.end(), Value) == Data.end())
+        Data.push_back(Value);
+    }
+  };
+  typedef unsigned hash_value_type;
+  typedef unsigned offset_type;
+  typedef TestFile *file_type;
+
+  typedef uint32_t external_key_type;
+  typedef uint32_t internal_key_type;
+
+  static bool EqualKey(uint32_t A, uint32_t B) { return A == B; }
+  static hash_value_type ComputeHash(uint32_t Key) {
+    return Key * 2654435761u;
+  }
+  static internal_key_type GetInternalKey(uint32_t Key) { return Key; }
+
+  static std::pair<unsigned, unsigned>
+  ReadKeyDataLength(const unsigned char *&D) {
+    using namespace llvm::support;
+    unsigned KeyLen = endian::readNext<uint16_t, little, unaligned>(D);
+    unsigned DataLen = endian::readNext<uint16_t, little, unaligned>(D);
+    return std::make_pair(KeyLen, DataLen);
+  }
+
+  internal_key_type ReadKey(const unsigned char *D, unsigned) {
+    using namespace llvm::support;
+    return endian::readNext<uint32_t, little, unaligned>(D);
+  }
+
+  void ReadDataInto(internal_key_type, const unsigned char *D,
+                    unsigned DataLen, data_type_builder &Val) {
+    using namespace llvm::support;
+    for (unsigned I = 0; I != DataLen / 4; ++I)
+      Val.insert(endian::readNext<uint32_t, little, unaligned>(D));
+  }
+
+  static void MergeDataInto(const data_type &From, data_type_builder &To) {
+    for (uint32_t Value : From)
+      To.insert(Value);
+  }
+
+  file_type ReadFileRef(const unsigned char *&D) {
+    using namespace llvm::support;
+    return &Files[endian::readNext<uint32_t, little, unaligned>(D)];
+  }
+};
+
+struct TestWriterInfo {
+  typedef uint32_t key_type;
+  typedef uint32_t key_type_ref;
+  typedef SmallVector<uint32_t, 4> data_type;
+  typedef const data_type &data_type_ref;
+  typedef unsigned hash_value_type;
+  typedef unsigned offset_type;
+
+  static bool EqualKey(uint32_t A, uint32_t B) { return A == B; }
+  hash_value_type ComputeHash(uint32_t Key) {
+    return TestReaderInfo::ComputeHash(Key);
+  }
+
+  std::pair<unsigned, unsigned>
+  EmitKeyDataLength(raw_ostream &Out, uint32_t, data_type_ref Data) {
+    using namespace llvm::support;
+    endian::Writer<little> LE(Out);
+    LE.write<uint16_t>(4);
+    LE.write<uint16_t>(4 * Data.size());
+    return std::make_pair(4, 4 * Data.size());
+  }
+
+  void EmitKey(raw_ostream &Out, uint32_t Key, unsigned) {
+    using namespace llvm::support;
+    endian::Writer<little>(Out).write<uint32_t>(Key);
+  }
+
+  void EmitData(raw_ostream &Out, uint32_t, data_type_ref Data, unsigned) {
+    using namespace llvm::support;
+    for (uint32_t Value : Data)
+      endian::Writer<little>(Out).write<uint32_t>(Value);
+  }
+
+  void EmitFileRef(raw_ostream &Out, TestFile *F) {
+    using namespace llvm::support;
+    endian::Writer<little>(Out).write<uint32_t>(F - Files);
+  }
+
+  data_type ImportData(const TestReaderInfo::data_type &FromReader) {
+    return FromReader;
+  }
+};
+
+typedef MultiOnDiskHashTable<TestReaderInfo> Table;
+typedef MultiOnDiskHashTableGenerator<TestReaderInfo, TestWriterInfo>
+    Generator;
+
+/// \brief Emit a table that maps each of \p Keys to itself plus \p Offset,
+/// on top of \p Base.
+void emitTable(ArrayRef<uint32_t> Keys, uint32_t Offset,
+               SmallVectorImpl<char> &Out, const Table *Base = nullptr) {
+  Generator Gen;
+  TestWriterInfo Info;
+  for (uint32_t Key : Keys) {
+    TestWriterInfo::data_type Data;
+    Data.push_back(Key + Offset);
+    Gen.insert(Key, Data, Info);
+  }
+  Gen.emit(Out, Info, Base);
+}
+
+/// \brief Read the key filter of the table in \p Data. The filter follows
+/// the bucket offset and the list of overridden files.
+OnDiskHashTableFilter readFilter(StringRef Data, uint32_t &NumWords) {
+  using namespace llvm::support;
+  const unsigned char *Ptr =
+      reinterpret_cast<const unsigned char *>(Data.data()) + 4;
+  uint32_t NumFiles = endian::readNext<uint32_t, little, unaligned>(Ptr);
+  Ptr += 4 * NumFiles;
+  NumWords = endian::readNext<uint32_t, little, unaligned>(Ptr);
+  return OnDiskHashTableFilter(Ptr, NumWords);
+}
+
+const unsigned char *bytes(StringRef Data) {
+  return reinterpret_cast<const unsigned char *>(Data.data());
+}
+
+TEST(MultiOnDiskHashTableTest, FilterRulesOutMissingKeys) {
+  std::vector<uint32_t> Keys;
+  for (uint32_t Key = 0; Key != 2000; Key += 2)
+    Keys.push_back(Key);
+  SmallString<0> Data;
+  emitTable(Keys, 1, Data);
+
+  uint32_t NumWords;
+  OnDiskHashTableFilter Filter = readFilter(Data, NumWords);
+  EXPECT_EQ(OnDiskHashTableFilter::getNumWords(Keys.size()), NumWords);
+
+  // Every key in the table passes the filter; most keys that aren't do not.
+  unsigned FalsePositives = 0;
+  for (uint32_t Key = 0; Key != 2000; ++Key) {
+    bool MayContain = Filter.mayContain(TestReaderInfo::ComputeHash(Key));
+    if (Key % 2 == 0)
+      EXPECT_TRUE(MayContain) << Key;
+    else if (MayContain)
+      ++FalsePositives;
+  }
+  EXPECT_LT(FalsePositives, 50u);
+
+  Table T;
+  T.add(&Files[0], bytes(Data));
+  for (uint32_t Key = 0; Key != 2000; ++Key) {
+    TestReaderInfo::data_type Result = T.find(Key);
+    if (Key % 2 == 0) {
+      ASSERT_EQ(1u, Result.size()) << Key;
+      EXPECT_EQ(Key + 1, Result[0]);
+    } else {
+      EXPECT_TRUE(Result.empty()) << Key;
+    }
+  }
+}
+
+TEST(MultiOnDiskHashTableTest, EmptyFilterMayContainAnything) {
+  OnDiskHashTableFilter Filter;
+  EXPECT_TRUE(Filter.mayContain(0));
+  EXPECT_TRUE(Filter.mayContain(TestReaderInfo::ComputeHash(42)));
+}
+
+TEST(MultiOnDiskHashTableTest, FilterCoversMergedKeys) {
+  // Load more tables than MaxTables, so that the first lookup merges them.
+  const unsigned NumBaseTables = TestReaderInfo::MaxTables + 1;
+  SmallString<0> BaseData[NumBaseTables];
+  Table Base;
+  for (unsigned I = 0; I != NumBaseTables; ++I) {
+    uint32_t Keys[] = {100 * I, 100 * I + 1};
+    emitTable(Keys, 1000, BaseData[I]);
+    Base.add(&Files[I], bytes(BaseData[I]));
+  }
+  EXPECT_EQ(1u, Base.find(1).size());
+
+  // A table emitted on top of the merged table overrides its files and takes
+  // over its entries, so its filter must cover them too.
+  uint32_t NewKeys[] = {7000, 7001};
+  SmallString<0> Data;
+  emitTable(NewKeys, 1, Data, &Base);
+
+  uint32_t NumWords;
+  OnDiskHashTableFilter Filter = readFilter(Data, NumWords);
+  EXPECT_EQ(OnDiskHashTableFilter::getNumWords(2 + 2 * NumBaseTables),
+            NumWords);
+  for (unsigned I = 0; I != NumBaseTables; ++I) {
+    EXPECT_TRUE(Filter.mayContain(TestReaderInfo::ComputeHash(100 * I)));
+    EXPECT_TRUE(Filter.mayContain(TestReaderInfo::ComputeHash(100 * I + 1)));
+  }
+  EXPECT_TRUE(Filter.mayContain(TestReaderInfo::ComputeHash(7000)));
+  EXPECT_TRUE(Filter.mayContain(TestReaderInfo::ComputeHash(7001)));
+
+  // Loading the new table on its own finds both the merged and the new keys.
+  Table T;
+  T.add(&Files[NumBaseTables], bytes(Data));
+  for (unsigned I = 0; I != NumBaseTables; ++I) {
+    TestReaderInfo::data_type Result = T.find(100 * I + 1);
+    ASSERT_EQ(1u, Result.size());
+    EXPECT_EQ(100 * I + 1001, Result[0]);
+  }
+  TestReaderInfo::data_type Result = T.find(7001);
+  ASSERT_EQ(1u, Result.size());
+  EXPECT_EQ(7002u, Result[0]);
+  EXPECT_TRUE(T.find(7002).empty());
+}
+
+} // end anonymous namespace